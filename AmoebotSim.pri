@@ -0,0 +1,92 @@
+# Simulation sources shared by the GUI application (AmoebotSim.pro) and the
+# headless command-line runner (cli/AmoebotSimCLI.pro). Everything listed here
+# depends only on QtCore and QtQml; GUI-only sources belong in AmoebotSim.pro.
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/alg/demo/ballroomdemo.h \
+    $$PWD/alg/demo/discodemo.h \
+    $$PWD/alg/demo/dynamicdemo.h \
+    $$PWD/alg/demo/metricsdemo.h \
+    $$PWD/alg/demo/tokendemo.h \
+    $$PWD/alg/aggregation.h \
+    $$PWD/alg/compression.h \
+    $$PWD/alg/edfhexagonformation.h \
+    $$PWD/alg/edfleaderelectionbyerosion.h \
+    $$PWD/alg/energyshape.h \
+    $$PWD/alg/energysharing.h \
+    $$PWD/alg/hexagonformation.h \
+    $$PWD/alg/immobilizedparticles.h \
+    $$PWD/alg/infobjcoating.h \
+    $$PWD/alg/leaderelectionbyerosion.h \
+    $$PWD/alg/shapeformation.h \
+    $$PWD/alg/leaderelection.h \
+    $$PWD/core/amoebotparticle.h \
+    $$PWD/core/amoebotsystem.h \
+    $$PWD/core/connectivitymonitor.h \
+    $$PWD/core/densitymap.h \
+    $$PWD/core/immoparticle.h \
+    $$PWD/core/labelset.h \
+    $$PWD/core/localparticle.h \
+    $$PWD/core/metric.h \
+    $$PWD/core/node.h \
+    $$PWD/core/nodehashmap.h \
+    $$PWD/core/occupancyindex.h \
+    $$PWD/core/particle.h \
+    $$PWD/core/particlearena.h \
+    $$PWD/core/particlepositions.h \
+    $$PWD/core/rendersnapshot.h \
+    $$PWD/core/scheduler.h \
+    $$PWD/core/simulator.h \
+    $$PWD/core/system.h \
+    $$PWD/core/tilegrid.h \
+    $$PWD/core/tokenstore.h \
+    $$PWD/core/trialrunner.h \
+    $$PWD/core/typedamoebot.h \
+    $$PWD/helper/philox.h \
+    $$PWD/helper/randomnumbergenerator.h \
+    $$PWD/script/scriptengine.h \
+    $$PWD/script/scriptinterface.h \
+    $$PWD/ui/algorithm.h
+
+SOURCES += \
+    $$PWD/alg/demo/ballroomdemo.cpp \
+    $$PWD/alg/demo/discodemo.cpp \
+    $$PWD/alg/demo/dynamicdemo.cpp \
+    $$PWD/alg/demo/metricsdemo.cpp \
+    $$PWD/alg/demo/tokendemo.cpp \
+    $$PWD/alg/aggregation.cpp \
+    $$PWD/alg/compression.cpp \
+    $$PWD/alg/edfhexagonformation.cpp \
+    $$PWD/alg/edfleaderelectionbyerosion.cpp \
+    $$PWD/alg/energyshape.cpp \
+    $$PWD/alg/energysharing.cpp \
+    $$PWD/alg/hexagonformation.cpp \
+    $$PWD/alg/immobilizedparticles.cpp \
+    $$PWD/alg/infobjcoating.cpp \
+    $$PWD/alg/leaderelectionbyerosion.cpp \
+    $$PWD/alg/shapeformation.cpp \
+    $$PWD/alg/leaderelection.cpp \
+    $$PWD/core/amoebotparticle.cpp \
+    $$PWD/core/amoebotsystem.cpp \
+    $$PWD/core/connectivitymonitor.cpp \
+    $$PWD/core/densitymap.cpp \
+    $$PWD/core/immoparticle.cpp \
+    $$PWD/core/localparticle.cpp \
+    $$PWD/core/metric.cpp \
+    $$PWD/core/occupancyindex.cpp \
+    $$PWD/core/particle.cpp \
+    $$PWD/core/particlearena.cpp \
+    $$PWD/core/particlepositions.cpp \
+    $$PWD/core/rendersnapshot.cpp \
+    $$PWD/core/scheduler.cpp \
+    $$PWD/core/simulator.cpp \
+    $$PWD/core/system.cpp \
+    $$PWD/core/tilegrid.cpp \
+    $$PWD/core/tokenstore.cpp \
+    $$PWD/core/trialrunner.cpp \
+    $$PWD/helper/randomnumbergenerator.cpp \
+    $$PWD/script/scriptengine.cpp \
+    $$PWD/script/scriptinterface.cpp \
+    $$PWD/ui/algorithm.cpp
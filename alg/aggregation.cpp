@@ -450,25 +450,27 @@ DispersionMeasure::DispersionMeasure(const QString name, const unsigned int freq
     _system(system) {}
 
 double DispersionMeasure::calculate() const {
-  QVector< QVector<double> > points;
+  // Sum the particles' distances to their centroid, reading the heads straight
+  // from the system's position arrays.
+  const ParticlePositions& positions = _system.positions();
+  const int n = positions.size();
+  const std::vector<int>& headX = positions.headX();
+  const std::vector<int>& headY = positions.headY();
 
-  for (const auto& p : _system.particles) {
-    points.push_back({(p->head.x + (p->head.y / 2.0)),
-                      (p->head.y * (sqrt(3.0) / 2.0))});
-  }
-
-  int n = points.length();
   double xSum = 0;
   double ySum = 0;
   for (int i = 0; i < n; i++) {
-    xSum += points[i][0];
-    ySum += points[i][1];
+    xSum += headX[i] + (headY[i] / 2.0);
+    ySum += headY[i] * (sqrt(3.0) / 2.0);
   }
-  QVector<double> centroid = {xSum / n, ySum / n};
+  const double centroidX = xSum / n;
+  const double centroidY = ySum / n;
 
   double dispersionSum = 0;
   for (int i = 0; i < n; i++) {
-    dispersionSum += dist(centroid, points[i]);
+    const double dx = headX[i] + (headY[i] / 2.0) - centroidX;
+    const double dy = headY[i] * (sqrt(3.0) / 2.0) - centroidY;
+    dispersionSum += sqrt(dx * dx + dy * dy);
   }
 
   return dispersionSum;
@@ -4,18 +4,16 @@
 
 #include "alg/compression.h"
 
-#include <algorithm>  // For distance() and find().
-#include <set>
-#include <vector>
+#include <algorithm>  // For find().
+#include <array>
 
 #include <QtGlobal>
 
-CompressionParticle::CompressionParticle(const Node head,
-                                         const int globalTailDir,
-                                         const int orientation,
-                                         AmoebotSystem& system,
-                                         const double lambda)
-  : AmoebotParticle(head, globalTailDir, orientation, system),
+CompressionParticle::CompressionParticle(
+    const Node head, const int globalTailDir, const int orientation,
+    AmoebotSystemT<CompressionParticle>& system, const double lambda)
+  : AmoebotParticleT<CompressionParticle>(head, globalTailDir, orientation,
+                                          system),
     lambda(lambda),
     q(0),
     numNbrsBefore(0),
@@ -28,7 +26,7 @@ void CompressionParticle::activate() {
 
     if (canExpand(expandDir) && !hasExpNbr()) {
       // Count neighbors in original position and expand.
-      numNbrsBefore = nbrCount(uniqueLabels());
+      numNbrsBefore = nbrCount(uniqueLabelSet());
       expand(expandDir);
       flag = !hasExpNbr();
     }
@@ -37,18 +35,19 @@ void CompressionParticle::activate() {
       contractHead();
     } else {
       // Count neighbors in new position and compute the set S.
-      int numNbrsAfter = nbrCount(headLabels());
-      std::vector<int> S;
+      const LabelSet nbrs = nbrLabels();
+      int numNbrsAfter = (headLabelSet() & nbrs).size();
+      LabelSet S;
       for (const int label : {headLabels()[4], tailLabels()[4]}) {
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
-          S.push_back(label);
+        if (nbrs.contains(label)) {
+          S.insert(label);
         }
       }
 
       // If the conditions are satisfied, contract to the new position;
       // otherwise, contract back to the original one.
       if ((q < pow(lambda, numNbrsAfter - numNbrsBefore))
-          && (checkProp1(S) || checkProp2(S))) {
+          && (checkProp1(S, nbrs) || checkProp2(S, nbrs))) {
         contractTail();
       } else {
         contractHead();
@@ -75,20 +74,16 @@ QString CompressionParticle::inspectionText() const {
   } else {  // isExpanded().
     text += "Expanded properties:\n";
     text += "  #neighbors before = " + QString::number(numNbrsBefore) + ",\n";
-    text += "  #neighbors after = " + QString::number(nbrCount(headLabels()))
+    text += "  #neighbors after = " + QString::number(nbrCount(headLabelSet()))
             + ".\n";
   }
 
   return text;
 }
 
-CompressionParticle& CompressionParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<CompressionParticle>(label);
-}
-
 bool CompressionParticle::hasExpNbr() const {
-  for (const int label: uniqueLabels()) {
-    if (hasNbrAtLabel(label) && nbrAtLabel(label).isExpanded()) {
+  for (const int label : occupiedLabels()) {
+    if (nbrAtLabel(label).isExpanded()) {
       return true;
     }
   }
@@ -101,18 +96,23 @@ bool CompressionParticle::hasExpHeadAtLabel(const int label) const {
          && nbrAtLabel(label).pointsAtMyHead(*this, label);
 }
 
-int CompressionParticle::nbrCount(std::vector<int> labels) const {
-  int numNbrs = 0;
-  for (const int label : labels) {
-    if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
-      ++numNbrs;
+LabelSet CompressionParticle::nbrLabels() const {
+  LabelSet nbrs;
+  for (const int label : occupiedLabels()) {
+    const CompressionParticle& nbr = nbrAtLabel(label);
+    if (!nbr.isExpanded() || !nbr.pointsAtMyHead(*this, label)) {
+      nbrs.insert(label);
     }
   }
 
-  return numNbrs;
+  return nbrs;
 }
 
-bool CompressionParticle::checkProp1(std::vector<int> S) const {
+int CompressionParticle::nbrCount(LabelSet labels) const {
+  return (labels & nbrLabels()).size();
+}
+
+bool CompressionParticle::checkProp1(LabelSet S, LabelSet nbrs) const {
   Q_ASSERT(isExpanded());
   Q_ASSERT(S.size() <= 2);
   Q_ASSERT(flag);  // Not required, but equivalent/cleaner for implementation.
@@ -120,19 +120,27 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
   if (S.size() == 0) {
     return false;  // S has to be nonempty for Property 1.
   } else {
-    const std::vector<int> labels = uniqueLabels();
-    std::set<int> adjNbrs;
+    // List the unique labels in counter-clockwise order.
+    const LabelSet uniqueLabels = uniqueLabelSet();
+    std::array<int, 10> labels;
+    const int numLabels = uniqueLabels.size();
+    int numListed = 0;
+    for (const int label : uniqueLabels) {
+      labels[numListed++] = label;
+    }
+    LabelSet adjNbrs;
 
     // Starting from the particles in S, sweep out and mark connected neighbors.
     for (int s : S) {
       adjNbrs.insert(s);
-      int i = distance(labels.begin(), find(labels.begin(), labels.end(), s));
+      int i = std::find(labels.begin(), labels.begin() + numLabels, s)
+              - labels.begin();
 
       // First sweep counter-clockwise, stopping when an unoccupied position or
       // expanded head is encountered.
-      for (uint offset = 1; offset < labels.size(); ++offset) {
-        int label = labels[(i + offset) % labels.size()];
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+      for (int offset = 1; offset < numLabels; ++offset) {
+        int label = labels[(i + offset) % numLabels];
+        if (nbrs.contains(label)) {
           adjNbrs.insert(label);
         } else {
           break;
@@ -140,9 +148,9 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
       }
 
       // Then sweep clockwise.
-      for (uint offset = 1; offset < labels.size(); ++offset) {
-        int label = labels[(i - offset + labels.size()) % labels.size()];
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+      for (int offset = 1; offset < numLabels; ++offset) {
+        int label = labels[(i - offset + numLabels) % numLabels];
+        if (nbrs.contains(label)) {
           adjNbrs.insert(label);
         } else {
           break;
@@ -153,11 +161,11 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
     // If all neighbors are connected to a particle in S by a path through the
     // neighborhood, then the number of labels in adjNbrs should equal the total
     // number of neighbors.
-    return adjNbrs.size() == (uint)nbrCount(labels);
+    return adjNbrs.size() == (uniqueLabels & nbrs).size();
   }
 }
 
-bool CompressionParticle::checkProp2(std::vector<int> S) const {
+bool CompressionParticle::checkProp2(LabelSet S, LabelSet nbrs) const {
   Q_ASSERT(isExpanded());
   Q_ASSERT(S.size() <= 2);
   Q_ASSERT(flag);  // Not required, but equivalent/cleaner for implementation.
@@ -165,14 +173,14 @@ bool CompressionParticle::checkProp2(std::vector<int> S) const {
   if (S.size() != 0) {
     return false;  // S has to be empty for Property 2.
   } else {
-    const int numHeadNbrs = nbrCount(headLabels());
-    const int numTailNbrs = nbrCount(tailLabels());
+    const int numHeadNbrs = (headLabelSet() & nbrs).size();
+    const int numTailNbrs = (tailLabelSet() & nbrs).size();
 
     // Check if the head's neighbors are connected.
     int numAdjHeadNbrs = 0;
     bool seenNbr = false;
     for (const int label : headLabels()) {
-      if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+      if (nbrs.contains(label)) {
         seenNbr = true;
         ++numAdjHeadNbrs;
       } else if (seenNbr) {
@@ -184,7 +192,7 @@ bool CompressionParticle::checkProp2(std::vector<int> S) const {
     int numAdjTailNbrs = 0;
     seenNbr = false;
     for (const int label : tailLabels()) {
-      if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+      if (nbrs.contains(label)) {
         seenNbr = true;
         ++numAdjTailNbrs;
       } else if (seenNbr) {
@@ -248,11 +256,11 @@ CompressionSystem::CompressionSystem(int numParticles, double lambda) {
         }
       }
 
-      insert(new CompressionParticle(Node(x, y), -1, randDir(), *this, lambda));
+      emplace<CompressionParticle>(Node(x, y), -1, randDir(), *this, lambda);
     }
   } else {  // In the unknown range or compression range, make a straight line.
     for (int i = 0; i < numParticles; ++i) {
-      insert(new CompressionParticle(Node(i, 0), -1, randDir(), *this, lambda));
+      emplace<CompressionParticle>(Node(i, 0), -1, randDir(), *this, lambda);
     }
   }
 
@@ -262,7 +270,7 @@ CompressionSystem::CompressionSystem(int numParticles, double lambda) {
 
 bool CompressionSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
         return true;
     }
   #endif
@@ -276,13 +284,17 @@ PerimeterMeasure::PerimeterMeasure(const QString name, const unsigned int freq,
       _system(system) {}
 
 double PerimeterMeasure::calculate() const {
+  // Count the (ordered) pairs of adjacent nodes that are both occupied by the
+  // tail of a particle, where a contracted particle's tail is its head. Each
+  // particle's tail node comes from the system's position arrays.
+  const ParticlePositions& positions = _system.positions();
   int numEdges = 0;
-  for (const auto& p : _system.particles) {
-    auto comp_p = dynamic_cast<CompressionParticle*>(p);
-    auto tailLabels = comp_p->isContracted() ? comp_p->uniqueLabels()
-                                             : comp_p->tailLabels();
-    for (const int label : tailLabels) {
-      if (comp_p->hasNbrAtLabel(label) && !comp_p->hasExpHeadAtLabel(label)) {
+  for (unsigned int i = 0; i < positions.size(); ++i) {
+    const Node tail = positions.tailNode(i);
+    for (int dir = 0; dir < 6; ++dir) {
+      const Node nbrNode = tail.nodeInDir(dir);
+      const AmoebotParticle* nbr = _system.occupancy.particleAt(nbrNode);
+      if (nbr != nullptr && (nbr->isContracted() || nbr->head != nbrNode)) {
         ++numEdges;
       }
     }
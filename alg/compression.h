@@ -15,8 +15,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class CompressionParticle : public AmoebotParticle {
+class CompressionParticle : public AmoebotParticleT<CompressionParticle> {
   friend class CompressionSystem;
   friend class PerimeterMeasure;
 
@@ -25,7 +26,8 @@ class CompressionParticle : public AmoebotParticle {
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, a system which it belongs to, and a bias parameter.
   CompressionParticle(const Node head, const int globalTailDir,
-                      const int orientation, AmoebotSystem& system,
+                      const int orientation,
+                      AmoebotSystemT<CompressionParticle>& system,
                       const double lambda);
 
   // Executes one particle activation.
@@ -43,27 +45,27 @@ protected:
   bool flag;
 
 private:
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  CompressionParticle& nbrAtLabel(int label) const;
-
   // hasExpNbr() checks whether this particle has an expanded neighbor, while
   // hasExpHeadAtLabel() checks whether the head of an expanded neighbor is at
   // the position at the specified label.
   bool hasExpNbr() const;
   bool hasExpHeadAtLabel(const int label) const;
 
+  // Returns the labels incident to a neighbor that is not the head of an
+  // expanded neighbor, i.e., the labels counted as neighbors by the algorithm.
+  LabelSet nbrLabels() const;
+
   // Counts the number of neighbors in the labeled positions. Note: this
   // implicitly assumes all neighbors are unique, as none are expanded.
-  int nbrCount(std::vector<int> labels) const;
+  int nbrCount(LabelSet labels) const;
 
-  // Functions for checking Properties 1 and 2 of the compression algorithm.
-  bool checkProp1(std::vector<int> S) const;
-  bool checkProp2(std::vector<int> S) const;
+  // Functions for checking Properties 1 and 2 of the compression algorithm,
+  // given the set S and the labels returned by nbrLabels().
+  bool checkProp1(LabelSet S, LabelSet nbrs) const;
+  bool checkProp2(LabelSet S, LabelSet nbrs) const;
 };
 
-class CompressionSystem : public AmoebotSystem {
+class CompressionSystem : public AmoebotSystemT<CompressionParticle> {
   friend class PerimeterMeasure;
 
  public:
@@ -131,7 +131,7 @@ BallroomDemoSystem::BallroomDemoSystem(unsigned int numParticles) {
   std::vector<int> rhombusDirs = {0, 1, 3, 4};
   for (int dir : rhombusDirs) {
     for (int i = 0; i < sideLen; ++i) {
-      insert(new ImmoParticle(boundNode));
+      emplace<ImmoParticle>(boundNode);
       boundNode = boundNode.nodeInDir(dir);
     }
   }
@@ -153,17 +153,14 @@ BallroomDemoSystem::BallroomDemoSystem(unsigned int numParticles) {
     // by setting the Follower's partner label to face the Leader.
     if (occupied.find(leaderNode) == occupied.end()
         && occupied.find(followerNode) == occupied.end()) {
-      BallroomDemoParticle* leader =
-          new BallroomDemoParticle(leaderNode, -1, randDir(), *this,
-                                   BallroomDemoParticle::State::Leader);
-      insert(leader);
+      emplace<BallroomDemoParticle>(leaderNode, -1, randDir(), *this,
+                                    BallroomDemoParticle::State::Leader);
       occupied.insert(leaderNode);
 
-      BallroomDemoParticle* follower =
-          new BallroomDemoParticle(followerNode, -1, randDir(), *this,
-                                   BallroomDemoParticle::State::Follower);
-      follower->_partnerLbl = follower->globalToLocalDir((followerDir + 3) % 6);
-      insert(follower);
+      BallroomDemoParticle& follower =
+          emplace<BallroomDemoParticle>(followerNode, -1, randDir(), *this,
+                                        BallroomDemoParticle::State::Follower);
+      follower._partnerLbl = follower.globalToLocalDir((followerDir + 3) % 6);
       occupied.insert(followerNode);
 
       numParticlesAdded += 2;
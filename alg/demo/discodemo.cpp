@@ -93,7 +93,7 @@ DiscoDemoSystem::DiscoDemoSystem(unsigned int numParticles, int counterMax) {
   Node boundNode(0, 0);
   for (int dir = 0; dir < 6; ++dir) {
     for (int i = 0; i < sideLen; ++i) {
-      insert(new ImmoParticle(boundNode));
+      emplace<ImmoParticle>(boundNode);
       boundNode = boundNode.nodeInDir(dir);
     }
   }
@@ -112,7 +112,7 @@ DiscoDemoSystem::DiscoDemoSystem(unsigned int numParticles, int counterMax) {
     // If the node satisfies (iii) and is unoccupied, place a particle there.
     if (0 < x + y && x + y < 2 * sideLen
         && occupied.find(node) == occupied.end()) {
-      insert(new DiscoDemoParticle(node, -1, randDir(), *this, counterMax));
+      emplace<DiscoDemoParticle>(node, -1, randDir(), *this, counterMax);
       occupied.insert(node);
     }
   }
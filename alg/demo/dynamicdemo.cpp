@@ -20,9 +20,9 @@ void DynamicDemoParticle::activate() {
   if (randDouble(0, 1) < _growProb) {
     int growDir = randDir();
     if (!hasNbrAtLabel(growDir)) {
-      system.insert(new DynamicDemoParticle(
+      system.emplace<DynamicDemoParticle>(
                       head.nodeInDir(localToGlobalDir(growDir)), -1, randDir(),
-                      system, _growProb, _dieProb));
+                      system, _growProb, _dieProb);
     }
   }
 
@@ -92,8 +92,8 @@ DynamicDemoSystem::DynamicDemoSystem(unsigned int numParticles, double growProb,
       }
     }
 
-    insert(new DynamicDemoParticle(Node(x, y), -1, randDir(), *this, growProb,
-                                   dieProb));
+    emplace<DynamicDemoParticle>(Node(x, y), -1, randDir(), *this, growProb,
+                                 dieProb);
   }
 }
 
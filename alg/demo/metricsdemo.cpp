@@ -5,7 +5,8 @@
 #include "alg/demo/metricsdemo.h"
 
 #include <algorithm>  // for std::max
-#include <cmath>      // for std::sqrt, std::pow
+#include <cmath>      // for std::sqrt
+#include <vector>
 
 MetricsDemoParticle::MetricsDemoParticle(const Node& head,
                                          const int globalTailDir,
@@ -36,7 +37,7 @@ void MetricsDemoParticle::activate() {
     if (canExpand(expandDir)) {
       expand(expandDir);
     } else if (hasObjectAtLabel(expandDir)) {
-      system.getCount("# Wall Bumps").record();
+      static_cast<MetricsDemoSystem&>(system)._wallBumpCount.record();
     }
   } else {  // isExpanded().
     contractTail();
@@ -92,14 +93,15 @@ MetricsDemoParticle::State MetricsDemoParticle::getRandColor() const {
   return static_cast<State>(randInt(0, 7));
 }
 
-MetricsDemoSystem::MetricsDemoSystem(unsigned int numParticles, int counterMax) {
+MetricsDemoSystem::MetricsDemoSystem(unsigned int numParticles, int counterMax)
+    : _wallBumpCount(addCount("# Wall Bumps")) {
   // In order to enclose an area that's roughly 3.7x the # of particles using a
   // regular hexagon, the hexagon should have side length 1.4*sqrt(# particles).
   int sideLen = static_cast<int>(std::round(1.4 * std::sqrt(numParticles)));
   Node boundNode(0, 0);
   for (int dir = 0; dir < 6; ++dir) {
     for (int i = 0; i < sideLen; ++i) {
-      insert(new ImmoParticle(boundNode));
+      emplace<ImmoParticle>(boundNode);
       boundNode = boundNode.nodeInDir(dir);
     }
   }
@@ -118,13 +120,12 @@ MetricsDemoSystem::MetricsDemoSystem(unsigned int numParticles, int counterMax)
     // If the node satisfies (iii) and is unoccupied, place a particle there.
     if (0 < x + y && x + y < 2 * sideLen
         && occupied.find(node) == occupied.end()) {
-      insert(new MetricsDemoParticle(node, -1, randDir(), *this, counterMax));
+      emplace<MetricsDemoParticle>(node, -1, randDir(), *this, counterMax);
       occupied.insert(node);
     }
   }
 
   // Set up metrics.
-  _counts.push_back(new Count("# Wall Bumps"));
   _measures.push_back(new PercentRedMeasure("% Red", 1, *this));
   _measures.push_back(new MaxDistanceMeasure("Max. Distance", 1, *this));
 }
@@ -157,17 +158,24 @@ MaxDistanceMeasure::MaxDistanceMeasure(const QString name,
       _system(system) {}
 
 double MaxDistanceMeasure::calculate() const {
-  double maxDist = 0.0;
-  for (const auto& p1 : _system.particles) {
-    double x1 = p1->head.x + p1->head.y / 2.0;
-    double y1 = std::sqrt(3.0) / 2 * p1->head.y;
-    for (const auto& p2 : _system.particles) {
-      double x2 = p2->head.x + p2->head.y / 2.0;
-      double y2 = std::sqrt(3.0) / 2 * p2->head.y;
-      maxDist = std::max(std::sqrt(std::pow(x2 - x1, 2) + std::pow(y2 - y1, 2)),
-                         maxDist);
+  // Convert the particles' heads to Cartesian coordinates once, then compare
+  // squared distances over all pairs, taking a single square root at the end.
+  const ParticlePositions& positions = _system.positions();
+  const unsigned int n = positions.size();
+  std::vector<double> xs(n), ys(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    xs[i] = positions.headX()[i] + positions.headY()[i] / 2.0;
+    ys[i] = std::sqrt(3.0) / 2 * positions.headY()[i];
+  }
+
+  double maxSquaredDist = 0.0;
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = i + 1; j < n; ++j) {
+      const double dx = xs[j] - xs[i];
+      const double dy = ys[j] - ys[i];
+      maxSquaredDist = std::max(dx * dx + dy * dy, maxSquaredDist);
     }
   }
 
-  return maxDist;
+  return std::sqrt(maxSquaredDist);
 }
@@ -73,6 +73,11 @@ class MetricsDemoSystem : public AmoebotSystem {
   // Constructs a system of the specified number of MetricsDemoParticles
   // enclosed by a hexagonal ring of objects.
   MetricsDemoSystem(unsigned int numParticles = 30, int counterMax = 5);
+
+ private:
+  friend class MetricsDemoParticle;
+
+  Count& _wallBumpCount;
 };
 
 class PercentRedMeasure : public Measure {
@@ -96,16 +96,16 @@ TokenDemoSystem::TokenDemoSystem(int numParticles, int lifetime) {
       if (hexNode.x == 0 && hexNode.y == 0) {
         auto firstP = new TokenDemoParticle(Node(0, 0), -1, randDir(), *this);
         for (int j = 0; j < 5; ++j) {
-          auto redToken = std::make_shared<TokenDemoParticle::RedToken>();
+          auto redToken = firstP->makeToken<TokenDemoParticle::RedToken>();
           redToken->_lifetime = lifetime;
           firstP->putToken(redToken);
-          auto blueToken = std::make_shared<TokenDemoParticle::BlueToken>();
+          auto blueToken = firstP->makeToken<TokenDemoParticle::BlueToken>();
           blueToken->_lifetime = lifetime;
           firstP->putToken(blueToken);
         }
         insert(firstP);
       } else {
-        insert(new TokenDemoParticle(hexNode, -1, randDir(), *this));
+        emplace<TokenDemoParticle>(hexNode, -1, randDir(), *this);
       }
 
       hexNode = hexNode.nodeInDir(dir);
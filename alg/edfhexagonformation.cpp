@@ -75,7 +75,7 @@ void EDFHexagonFormationParticle::activate() {
              && (_sState == ShapeState::Follower
                  || _sState == ShapeState::Root)
              && !hasNbrInState({ShapeState::Idle})
-             && !conTailChildLabels().empty()) {
+             && conTailChildLabel() != -1) {
       _battery -= _demand;  // Spend energy.
       if (_sState == ShapeState::Root)
         _hexagonDir = nextHexagonDir(1);  // clockwise.
@@ -85,7 +85,7 @@ void EDFHexagonFormationParticle::activate() {
       prune();
 
       // Choose any contracted tail child to pull in a handover.
-      int childLabel = conTailChildLabels()[0];
+      int childLabel = conTailChildLabel();
       auto child = nbrAtLabel(childLabel);
 
       // Pulling this child will make it expand, so we need to update its energy
@@ -120,7 +120,7 @@ void EDFHexagonFormationParticle::activate() {
 
   // Compute various neighbor sets used in the EnergyDistribution action.
   std::vector<int> idleNbrLabels;
-  for (int label : uniqueLabels())
+  for (int label : uniqueLabelSet())
     if (hasNbrAtLabel(label) && nbrAtLabel(label)._eState == EnergyState::Idle)
       idleNbrLabels.push_back(label);
 
@@ -147,7 +147,7 @@ void EDFHexagonFormationParticle::activate() {
       || _eState == EnergyState::Growing) {  // GrowForest
     // Adopt idle neighbors as active children.
     for (int label : idleNbrLabels) {
-      for (int nbrLabel : nbrAtLabel(label).uniqueLabels()) {
+      for (int nbrLabel : nbrAtLabel(label).uniqueLabelSet()) {
         if (pointsAtMe(nbrAtLabel(label), nbrLabel)) {
           nbrAtLabel(label)._eParentLabel = nbrLabel;
           break;
@@ -297,7 +297,7 @@ bool EDFHexagonFormationParticle::hasNbrInState(
 
 const std::vector<int> EDFHexagonFormationParticle::eChildLabels() const {
   std::vector<int> labels;
-  for (int label : uniqueLabels())
+  for (int label : uniqueLabelSet())
     if (hasNbrAtLabel(label)
         && nbrAtLabel(label)._eParentLabel != -1
         && pointsAtMe(nbrAtLabel(label), nbrAtLabel(label)._eParentLabel))
@@ -381,16 +381,16 @@ bool EDFHexagonFormationParticle::hasTailChild() const {
   return labelOfFirstNbrWithProperty<EDFHexagonFormationParticle>(prop) != -1;
 }
 
-const std::vector<int> EDFHexagonFormationParticle::conTailChildLabels() const {
-  std::vector<int> labels;
+int EDFHexagonFormationParticle::conTailChildLabel() const {
+  const LabelSet occupied = occupiedLabels();
   for (int label : tailLabels())
-    if (hasNbrAtLabel(label)
+    if (occupied.contains(label)
         && nbrAtLabel(label).isContracted()
         && nbrAtLabel(label)._sParentDir != -1
         && pointsAtMyTail(nbrAtLabel(label), nbrAtLabel(label)._sParentDir))
-      labels.push_back(label);
+      return label;
 
-  return labels;
+  return -1;
 }
 
 EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
@@ -401,9 +401,9 @@ EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
                                                      int demand) {
   // Insert the shape formation seed at (0,0).
   std::set<Node> occupied;
-  insert(new EDFHexagonFormationParticle(
+  emplace<EDFHexagonFormationParticle>(
       Node(0, 0), *this, capacity, transferRate, demand,
-      EDFHexagonFormationParticle::ShapeState::Seed));
+      EDFHexagonFormationParticle::ShapeState::Seed);
   occupied.insert(Node(0, 0));
 
   // Initialize the candidate positions set.
@@ -430,9 +430,9 @@ EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new EDFHexagonFormationParticle(
+      emplace<EDFHexagonFormationParticle>(
           randCand, *this, capacity, transferRate, demand,
-          EDFHexagonFormationParticle::ShapeState::Idle));
+          EDFHexagonFormationParticle::ShapeState::Idle);
       occupied.insert(randCand);
       particlesAdded++;
 
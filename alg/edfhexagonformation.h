@@ -109,9 +109,10 @@ class EDFHexagonFormationParticle : public AmoebotParticle {
   // points at this particle's tail.
   bool hasTailChild() const;
 
-  // Returns a list of labels that uniquely address any contracted neighbors
-  // whose _sParent variable points at this particle's tail.
-  const std::vector<int> conTailChildLabels() const;
+  // Returns the first label (in the order of tailLabels()) that addresses a
+  // contracted neighbor whose _sParent variable points at this particle's tail,
+  // or -1 if there is no such neighbor.
+  int conTailChildLabel() const;
 
  protected:
   // Energy distribution framework parameters.
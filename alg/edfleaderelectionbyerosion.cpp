@@ -45,7 +45,7 @@ void EDFLeaderElectionByErosionParticle::activate() {
 
   // Compute various neighbor sets used in the EnergyDistribution action.
   std::vector<int> idleNbrLabels;
-  for (int label : uniqueLabels())
+  for (int label : uniqueLabelSet())
     if (hasNbrAtLabel(label) && nbrAtLabel(label)._eState == EnergyState::Idle)
       idleNbrLabels.push_back(label);
 
@@ -211,7 +211,7 @@ bool EDFLeaderElectionByErosionParticle::hasNbrInState(
 
 const std::vector<int> EDFLeaderElectionByErosionParticle::childLabels() const {
   std::vector<int> labels;
-  for (int label : uniqueLabels())
+  for (int label : uniqueLabelSet())
     if (hasNbrAtLabel(label)
         && nbrAtLabel(label)._eParentDir != -1
         && pointsAtMe(nbrAtLabel(label), nbrAtLabel(label)._eParentDir))
@@ -254,7 +254,7 @@ int EDFLeaderElectionByErosionParticle::energyColor(int color) const {
 bool EDFLeaderElectionByErosionParticle::canErode() const {
   // First, count the number of candidate neighbors.
   uint numCandNbrs = 0;
-  for (int label : uniqueLabels()) {
+  for (int label : uniqueLabelSet()) {
     if (hasNbrAtLabel(label)
         && nbrAtLabel(label)._lState == LeaderState::Candidate)
       ++numCandNbrs;
@@ -355,8 +355,8 @@ EDFLeaderElectionByErosionSystem::EDFLeaderElectionByErosionSystem(
       }
     }
 
-    insert(new EDFLeaderElectionByErosionParticle(Node(x, y), *this, capacity,
-                                                  transferRate, demand));
+    emplace<EDFLeaderElectionByErosionParticle>(Node(x, y), *this, capacity,
+                                                transferRate, demand);
   }
 
   // Choose source particles uniformly at random.
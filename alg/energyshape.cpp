@@ -7,15 +7,13 @@
 #include <algorithm>
 #include <set>
 
-EnergyShapeParticle::EnergyShapeParticle(const Node& head, int globalTailDir,
-                                         const int orientation,
-                                         AmoebotSystem& system,
-                                         const double capacity,
-                                         const double demand,
-                                         const double transferRate,
-                                         const EnergyState eState,
-                                         const ShapeState sState)
-    : AmoebotParticle(head, globalTailDir, orientation, system),
+EnergyShapeParticle::EnergyShapeParticle(
+    const Node& head, int globalTailDir, const int orientation,
+    AmoebotSystemT<EnergyShapeParticle>& system, const double capacity,
+    const double demand, const double transferRate, const EnergyState eState,
+    const ShapeState sState)
+    : AmoebotParticleT<EnergyShapeParticle>(head, globalTailDir, orientation,
+                                            system),
       _capacity(capacity),
       _demand(demand),
       _transferRate(transferRate),
@@ -89,6 +87,13 @@ int EnergyShapeParticle::tailMarkColor() const {
   return headMarkColor();
 }
 
+int EnergyShapeParticle::trackedState() const {
+  const bool isDone = !_stress && !_inhibit &&
+                      (_sState == ShapeState::Seed ||
+                       _sState == ShapeState::Finish);
+  return isDone ? 1 : 0;
+}
+
 QString EnergyShapeParticle::inspectionText() const {
   QString text;
   text += "Global Info:\n";
@@ -131,10 +136,6 @@ QString EnergyShapeParticle::inspectionText() const {
   return text;
 }
 
-EnergyShapeParticle& EnergyShapeParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<EnergyShapeParticle>(label);
-}
-
 void EnergyShapeParticle::prune() {
   int labelLimit = isContracted() ? 6 : 10;
   for (int nbrLabel = 0; nbrLabel < labelLimit; nbrLabel++) {
@@ -279,7 +280,7 @@ void EnergyShapeParticle::useEnergy() {
 
     if (didAction) {
       _battery -= _demand;
-      system.getCount("# Actions").record();
+      static_cast<EnergyShapeSystem&>(system)._actionCount.record();
     }
   }
 }
@@ -374,15 +375,18 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
                                      const double holeProb,
                                      const double capacity,
                                      const double demand,
-                                     const double transferRate) {
-  _counts.push_back(new Count("# Actions"));
+                                     const double transferRate)
+    : _actionCount(addCount("# Actions")) {
+  // Particles probe each of their neighbors several times per activation, so
+  // they read neighbors from the adjacency cache.
+  setAdjacencyCached(true);
 
   // Insert the energy distribution root/shape formation seed at (0,0).
   std::set<Node> occupied;
-  insert(new EnergyShapeParticle(Node(0, 0), -1, randDir(), *this, capacity,
-                                 demand, transferRate,
-                                 EnergyShapeParticle::EnergyState::Idle,
-                                 EnergyShapeParticle::ShapeState::Seed));
+  emplace<EnergyShapeParticle>(Node(0, 0), -1, randDir(), *this, capacity,
+                               demand, transferRate,
+                               EnergyShapeParticle::EnergyState::Idle,
+                               EnergyShapeParticle::ShapeState::Seed);
   occupied.insert(Node(0, 0));
 
   std::set<Node> candidates;
@@ -408,10 +412,10 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new EnergyShapeParticle(randCand, -1, randDir(), *this, capacity,
-                                     demand, transferRate,
-                                     EnergyShapeParticle::EnergyState::Idle,
-                                     EnergyShapeParticle::ShapeState::Idle));
+      emplace<EnergyShapeParticle>(randCand, -1, randDir(), *this, capacity,
+                                   demand, transferRate,
+                                   EnergyShapeParticle::EnergyState::Idle,
+                                   EnergyShapeParticle::ShapeState::Idle);
       occupied.insert(randCand);
       particlesAdded++;
 
@@ -441,14 +445,6 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
 }
 
 bool EnergyShapeSystem::hasTerminated() const {
-  for (auto p : particles) {
-    auto esp = dynamic_cast<EnergyShapeParticle*>(p);
-    if (esp->_stress || esp->_inhibit ||
-        (esp->_sState != EnergyShapeParticle::ShapeState::Seed
-         && esp->_sState != EnergyShapeParticle::ShapeState::Finish)) {
-      return false;
-    }
-  }
-
-  return true;
+  // See EnergyShapeParticle::trackedState.
+  return numInTrackedState(1) == particles.size();
 }
@@ -11,8 +11,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class EnergyShapeParticle : public AmoebotParticle {
+class EnergyShapeParticle : public AmoebotParticleT<EnergyShapeParticle> {
  public:
   enum class EnergyState {
     Root,
@@ -34,7 +35,8 @@ class EnergyShapeParticle : public AmoebotParticle {
   // battery, an energy demand for its actions, an energy transfer rate, an
   // energy state, and a shape state.
   EnergyShapeParticle(const Node& head, int globalTailDir,
-                      const int orientation, AmoebotSystem& system,
+                      const int orientation,
+                      AmoebotSystemT<EnergyShapeParticle>& system,
                       const double capacity, const double demand,
                       const double transferRate, const EnergyState eState,
                       const ShapeState sState);
@@ -55,10 +57,10 @@ class EnergyShapeParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   QString inspectionText() const override;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  EnergyShapeParticle& nbrAtLabel(int label) const;
+  // Returns 1 if this particle is done (neither stressed nor inhibited, and in
+  // ShapeState::Seed or ShapeState::Finish) and 0 otherwise, so the system can
+  // count the particles that are done.
+  int trackedState() const override;
 
   // Sets all energy children's prune flags to true, resets flags in memory,
   // removes energy parent label, and resets energy state to idle (if active).
@@ -135,7 +137,7 @@ class EnergyShapeParticle : public AmoebotParticle {
   friend class EnergyShapeSystem;
 };
 
-class EnergyShapeSystem : public AmoebotSystem {
+class EnergyShapeSystem : public AmoebotSystemT<EnergyShapeParticle> {
  public:
   // Constructs a system of EnergyShapeParticles with an optionally specified
   // size (# particles), number of energy distribution root particles, hole
@@ -148,6 +150,11 @@ class EnergyShapeSystem : public AmoebotSystem {
   // Checks whether the system has completed forming the desired shape (i.e.,
   // all particles are in shape state Finish).
   bool hasTerminated() const override;
+
+ private:
+  friend class EnergyShapeParticle;
+
+  Count& _actionCount;
 };
 
 #endif  // ALG_ENERGYSHAPE_H_
@@ -6,16 +6,13 @@
 
 #include <algorithm>  // for std::min, std::max.
 
-EnergySharingParticle::EnergySharingParticle(const Node& head,
-                                             int globalTailDir,
-                                             const int orientation,
-                                             AmoebotSystem& system,
-                                             const double capacity,
-                                             const double demand,
-                                             const double transferRate,
-                                             const Usage usage,
-                                             const State state)
-    : AmoebotParticle (head, globalTailDir, orientation, system),
+EnergySharingParticle::EnergySharingParticle(
+    const Node& head, int globalTailDir, const int orientation,
+    AmoebotSystemT<EnergySharingParticle>& system, const double capacity,
+    const double demand, const double transferRate, const Usage usage,
+    const State state)
+    : AmoebotParticleT<EnergySharingParticle>(head, globalTailDir, orientation,
+                                              system),
       _capacity(capacity),
       _demand(demand),
       _transferRate(transferRate),
@@ -100,10 +97,6 @@ QString EnergySharingParticle::inspectionText() const {
   return text;
 }
 
-EnergySharingParticle& EnergySharingParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<EnergySharingParticle>(label);
-}
-
 void EnergySharingParticle::communicate() {
   bool hasStressChild = false;
   for (int nbrDir = 0; nbrDir < 6; nbrDir++) {
@@ -154,7 +147,7 @@ void EnergySharingParticle::useEnergy() {
   if (!_inhibit && _battery >= _demand) {
     if (_usage == Usage::Uniform) {
       _battery -= _demand;
-      system.getCount("# Actions").record();
+      static_cast<EnergySharingSystem&>(system)._actionCount.record();
     } else if (_usage == Usage::Reproduce) {
       int reproduceDir = -1;
       for (int dir = 0; dir < 6; dir++) {
@@ -166,11 +159,13 @@ void EnergySharingParticle::useEnergy() {
 
       if (reproduceDir != -1) {
         _battery -= _demand;
-        system.getCount("# Actions").record();
-        system.insert(new EnergySharingParticle(
+        EnergySharingSystem& sharingSystem =
+            static_cast<EnergySharingSystem&>(system);
+        sharingSystem._actionCount.record();
+        sharingSystem.emplace<EnergySharingParticle>(
                         head.nodeInDir(localToGlobalDir(reproduceDir)), -1,
-                        randDir(), system, _capacity, _demand, _transferRate,
-                        _usage, State::Idle));
+                        randDir(), sharingSystem, _capacity, _demand,
+                        _transferRate, _usage, State::Idle);
       }
     } else {
       Q_ASSERT(false);  // An invalid usage type was used.
@@ -203,9 +198,8 @@ EnergySharingSystem::EnergySharingSystem(int numParticles,
                                          const int usage,
                                          const double capacity,
                                          const double demand,
-                                         const double transferRate) {
-  _counts.push_back(new Count("# Actions"));
-
+                                         const double transferRate)
+    : _actionCount(addCount("# Actions")) {
   // Add a hexagon of idle particles to the system.
   int x, y;
   for (int i = 1; i <= numParticles; ++i) {
@@ -250,10 +244,10 @@ EnergySharingSystem::EnergySharingSystem(int numParticles,
       }
     }
 
-    insert(new EnergySharingParticle(Node(x, y), -1, randDir(), *this,
-                                     capacity, demand, transferRate,
-                                     static_cast<EnergySharingParticle::Usage>(usage),
-                                     EnergySharingParticle::State::Idle));
+    emplace<EnergySharingParticle>(Node(x, y), -1, randDir(), *this,
+                                   capacity, demand, transferRate,
+                                   static_cast<EnergySharingParticle::Usage>(usage),
+                                   EnergySharingParticle::State::Idle);
   }
 
   // Choose particles at random to make energy ditribution roots.
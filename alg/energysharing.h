@@ -11,8 +11,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class EnergySharingParticle : public AmoebotParticle {
+class EnergySharingParticle : public AmoebotParticleT<EnergySharingParticle> {
  public:
   enum class Usage {
     Uniform,
@@ -31,7 +32,8 @@ class EnergySharingParticle : public AmoebotParticle {
   // battery, an energy demand for its actions, an energy transfer rate, an
   // energy usage mode, and a state.
   EnergySharingParticle(const Node& head, int globalTailDir,
-                        const int orientation, AmoebotSystem& system,
+                        const int orientation,
+                        AmoebotSystemT<EnergySharingParticle>& system,
                         const double capacity, const double demand,
                         const double transferRate, const Usage usage,
                         const State state);
@@ -52,11 +54,6 @@ class EnergySharingParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   QString inspectionText() const override;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  EnergySharingParticle& nbrAtLabel(int label) const;
-
   // The three phases of the energy distribution algorithm. The communication
   // phase propagates signals communicating particles' energy levels, the
   // sharing phase gathers energy from the source and shares with a neighbor,
@@ -90,7 +87,7 @@ class EnergySharingParticle : public AmoebotParticle {
   friend class EnergySharingSystem;
 };
 
-class EnergySharingSystem : public AmoebotSystem {
+class EnergySharingSystem : public AmoebotSystemT<EnergySharingParticle> {
  public:
   // Constructs a system of EnergySharingParticles with an optionally specified
   // size (# particles), number of energy roots, energy usage mode (0 for
@@ -99,6 +96,11 @@ class EnergySharingSystem : public AmoebotSystem {
   EnergySharingSystem(int numParticles, const int numEnergyRoots,
                       const int usage, const double capacity,
                       const double demand, const double transferRate);
+
+ private:
+  friend class EnergySharingParticle;
+
+  Count& _actionCount;
 };
 
 #endif  // ALG_ENERGYSHARING_H_
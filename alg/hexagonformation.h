@@ -16,8 +16,10 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class HexagonFormationParticle : public AmoebotParticle {
+class HexagonFormationParticle
+    : public AmoebotParticleT<HexagonFormationParticle> {
  public:
   enum class State {
     Seed,      // The unique particle centering the hexagon.
@@ -30,7 +32,8 @@ class HexagonFormationParticle : public AmoebotParticle {
   // Constructs a new contracted particle with a node position for its head, a
   // particle system it belongs to, and an initial state (either State::Seed or
   // State::Idle).
-  HexagonFormationParticle(const Node head, AmoebotSystem& system,
+  HexagonFormationParticle(const Node head,
+                           AmoebotSystemT<HexagonFormationParticle>& system,
                            const State state);
 
   // Executes one particle activation.
@@ -49,10 +52,12 @@ class HexagonFormationParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   QString inspectionText() const override;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  HexagonFormationParticle& nbrAtLabel(int label) const;
+  // Returns this particle's state, so the system can count particles per state.
+  int trackedState() const override;
+
+  // Returns true if this particle is the seed or retired, as such particles
+  // never act again.
+  bool isQuiescent() const override;
 
   // Returns the label of the first port incident to a neighboring particle in
   // any of the specified states, starting at the (optionally) specified label
@@ -77,9 +82,10 @@ class HexagonFormationParticle : public AmoebotParticle {
   // points at this particle's tail.
   bool hasTailChild() const;
 
-  // Returns a list of labels that uniquely address any contracted neighbors
-  // whose _sParent variable points at this particle's tail.
-  const std::vector<int> conTailChildLabels() const;
+  // Returns the first label (in the order of tailLabels()) that addresses a
+  // contracted neighbor whose _sParent variable points at this particle's tail,
+  // or -1 if there is no such neighbor.
+  int conTailChildLabel() const;
 
  protected:
   // Particle memory.
@@ -91,7 +97,7 @@ class HexagonFormationParticle : public AmoebotParticle {
   friend class HexagonFormationSystem;
 };
 
-class HexagonFormationSystem : public AmoebotSystem {
+class HexagonFormationSystem : public AmoebotSystemT<HexagonFormationParticle> {
  public:
   // Constructs a system of HexagonFormationParticles with an optionally
   // specified size (#particles) and hole probability in [0,1) controlling how
@@ -99,7 +105,7 @@ class HexagonFormationSystem : public AmoebotSystem {
   HexagonFormationSystem(int numParticles = 200, double holeProb = 0.2);
 
   // Checks whether the system has formed a hexagon (i.e., all particles are in
-  // State::Seed or State::Retired).
+  // State::Seed or State::Retired) by comparing state populations, in O(1).
   bool hasTerminated() const override;
 };
 
@@ -119,7 +119,7 @@ void Immobilizedparticles::tryToBecomeLeader() {
 
     // Find the label that corresponds to the current token direction.
     int label = 0;
-    for (int l : uniqueLabels()) {
+    for (int l : uniqueLabelSet()) {
         if (labelToDir(l) == tokenCurrentDir) {
             label = l;
         }
@@ -206,7 +206,7 @@ void Immobilizedparticles::performMovement() {
     updateBorderColors(); // Only necessary for the visualisation.
 }
 bool Immobilizedparticles::hasBlockingTailNbr() const {
-    for (int label : uniqueLabels()) {
+    for (int label : uniqueLabelSet()) {
         if (hasNbrAtLabel(label)) {
             auto& nbr = nbrAtLabel(label);
             if (nbr.isInState({State::Idle})
@@ -231,7 +231,7 @@ void Immobilizedparticles::updateBoolStates() {
     }
 
     freeState = true;
-    for (int label : uniqueLabels()) {
+    for (int label : uniqueLabelSet()) {
         if (hasNbrAtLabel(label)) {
             auto& nbr = nbrAtLabel(label);
             if (nbr.isInState({State::Follower}) && pointsAtMe(nbr, nbr.dirToHeadLabel(nbr.followDir))) {
@@ -267,7 +267,7 @@ void Immobilizedparticles::updateBoolStates() {
     }
 
     lineState = true;
-    for (int label : uniqueLabels()) {
+    for (int label : uniqueLabelSet()) {
         if (hasNbrAtLabel(label)) {
             auto& nbr = nbrAtLabel(label);
             if (nbr.isInState({State::Follower}) && pointsAtMe(nbr, nbr.dirToHeadLabel(nbr.followDir))) {
@@ -521,8 +521,7 @@ ImmobilizedParticleSystem::ImmobilizedParticleSystem(int numParticles, int numIm
     std::set<Node> candidates;
 
     _seedOrientation = randDir();
-    Immobilizedparticles* leader = new Immobilizedparticles(Node(0, 0), -1, seedOrientation(), *this, Immobilizedparticles::State::Leader);
-    insert(leader);
+    emplace<Immobilizedparticles>(Node(0, 0), -1, seedOrientation(), *this, Immobilizedparticles::State::Leader);
     occupied.insert(Node(0, 0));
     numParticles--;
 
@@ -538,7 +537,7 @@ ImmobilizedParticleSystem::ImmobilizedParticleSystem(int numParticles, int numIm
 
         if (randBool((double) numParticles / ((double) numParticles + (double) numImmoParticles))) {
             numParticles--;
-            insert(new Immobilizedparticles(randomCandidate, -1, randDir(), *this, Immobilizedparticles::State::Idle));
+            emplace<Immobilizedparticles>(randomCandidate, -1, randDir(), *this, Immobilizedparticles::State::Idle);
         } else {
             // Avoid adding an immobilized particle if it is enclosed by non-immobilized particles
             bool isEnclosed = true;
@@ -552,7 +551,7 @@ ImmobilizedParticleSystem::ImmobilizedParticleSystem(int numParticles, int numIm
 
             if (!isEnclosed) {  // Only insert if not enclosed by non-immobilized particles
                 numImmoParticles--;
-                insert(new ImmoParticle(randomCandidate));
+                emplace<ImmoParticle>(randomCandidate);
             }
         }
 
@@ -571,7 +570,7 @@ ImmobilizedParticleSystem::ImmobilizedParticleSystem(int numParticles, int numIm
 
 bool ImmobilizedParticleSystem::hasTerminated() const {
 #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
         return true;
     }
 #endif
@@ -6,11 +6,11 @@
 
 #include <set>
 
-InfObjCoatingParticle::InfObjCoatingParticle(const Node head,
-                                             const int globalTailDir,
-                                             const int orientation,
-                                             AmoebotSystem &system, State state)
-  : AmoebotParticle(head, globalTailDir, orientation, system),
+InfObjCoatingParticle::InfObjCoatingParticle(
+    const Node head, const int globalTailDir, const int orientation,
+    AmoebotSystemT<InfObjCoatingParticle>& system, State state)
+  : AmoebotParticleT<InfObjCoatingParticle>(head, globalTailDir, orientation,
+                                            system),
     state(state),
     moveDir(-1) {}
 
@@ -63,7 +63,7 @@ void InfObjCoatingParticle::activate() {
     } else if (state == State::Leader) {
       // If has a follower child, generate a complaint token if not holding one.
       if (hasFollowerChild() && !hasToken<ComplaintToken>()) {
-        putToken(std::make_shared<ComplaintToken>());
+        putToken(makeToken<ComplaintToken>());
       }
 
       // Only act if holding a complaint token.
@@ -138,10 +138,6 @@ QString InfObjCoatingParticle::inspectionText() const {
   return text;
 }
 
-InfObjCoatingParticle& InfObjCoatingParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<InfObjCoatingParticle>(label);
-}
-
 int InfObjCoatingParticle::labelOfFirstNbrInState(
     std::initializer_list<State> states, int startLabel) const {
   auto prop = [&](const InfObjCoatingParticle& p) {
@@ -194,7 +190,7 @@ InfObjCoatingSystem::InfObjCoatingSystem(uint numParticles, double holeProb) {
   Node objPos;
   while (objNodes.size() < numParticles * 2) {
     // Insert a new object particle at the given position.
-    insert(new ImmoParticle(objPos));
+    emplace<ImmoParticle>(objPos);
     objNodes.insert(objPos);
 
     // Calculate the next object position, avoiding 'tunnels'. Do this using
@@ -226,8 +222,8 @@ InfObjCoatingSystem::InfObjCoatingSystem(uint numParticles, double holeProb) {
     for (auto candPos : candidates) {
       // Place a particle at the candidate position with probability 1 - hole.
       if (particleNodes.size() < numParticles && randBool(1 - holeProb)) {
-        insert(new InfObjCoatingParticle(candPos, -1, randDir(), *this,
-                                       InfObjCoatingParticle::State::Inactive));
+        emplace<InfObjCoatingParticle>(candPos, -1, randDir(), *this,
+                                       InfObjCoatingParticle::State::Inactive);
         particleNodes.insert(candPos);
         lastAdded.insert(candPos);
       }
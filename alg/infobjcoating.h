@@ -16,8 +16,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class InfObjCoatingParticle : public AmoebotParticle {
+class InfObjCoatingParticle : public AmoebotParticleT<InfObjCoatingParticle> {
  public:
   enum class State {
     Inactive,  // Initial state.
@@ -29,7 +30,8 @@ class InfObjCoatingParticle : public AmoebotParticle {
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, a system which it belongs to, and an initial state.
   InfObjCoatingParticle(const Node head, const int globalTailDir,
-                        const int orientation, AmoebotSystem& system,
+                        const int orientation,
+                        AmoebotSystemT<InfObjCoatingParticle>& system,
                         State state);
 
   // Executes one particle activation.
@@ -48,11 +50,6 @@ class InfObjCoatingParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   QString inspectionText() const override;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  InfObjCoatingParticle& nbrAtLabel(int label) const;
-
   // labelOfFirstNbrInState returns the label of the first port incident to a
   // neighboring particle in any of the specified states, starting at the
   // (optionally) specified label and continuing counterclockwise.
@@ -83,7 +80,7 @@ class InfObjCoatingParticle : public AmoebotParticle {
   friend class InfObjCoatingSystem;
 };
 
-class InfObjCoatingSystem : public AmoebotSystem {
+class InfObjCoatingSystem : public AmoebotSystemT<InfObjCoatingParticle> {
  public:
   // Constructs a system of InfObjCoatingParticles connected to a randomly
   // generated surface (with no tunnels). Takes an optionally specified size
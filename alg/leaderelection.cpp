@@ -10,12 +10,11 @@
 
 //----------------------------BEGIN PARTICLE CODE----------------------------
 
-LeaderElectionParticle::LeaderElectionParticle(const Node head,
-                                               const int globalTailDir,
-                                               const int orientation,
-                                               AmoebotSystem& system,
-                                               State state)
-  : AmoebotParticle(head, globalTailDir, orientation, system),
+LeaderElectionParticle::LeaderElectionParticle(
+    const Node head, const int globalTailDir, const int orientation,
+    AmoebotSystemT<LeaderElectionParticle>& system, State state)
+  : AmoebotParticleT<LeaderElectionParticle>(head, globalTailDir, orientation,
+                                             system),
     state(state),
     currentAgent(0) {
   borderColorLabels.fill(-1);
@@ -102,6 +101,10 @@ int LeaderElectionParticle::tailMarkColor() const {
   return headMarkColor();
 }
 
+int LeaderElectionParticle::trackedState() const {
+  return static_cast<int>(state);
+}
+
 QString LeaderElectionParticle::inspectionText() const {
   QString text;
   QString indent = "    ";
@@ -175,10 +178,6 @@ std::array<int, 6> LeaderElectionParticle::borderPointColors() const {
   return borderPointColorLabels;
 }
 
-LeaderElectionParticle& LeaderElectionParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<LeaderElectionParticle>(label);
-}
-
 int LeaderElectionParticle::getNextAgentDir(const int agentDir) const {
   Q_ASSERT(!hasNbrAtLabel(agentDir));
 
@@ -247,7 +246,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         takeAgentToken<SegmentLeadToken>(prevAgentDir);
         passAgentToken<PassiveSegmentToken>
             (prevAgentDir,
-             std::make_shared<PassiveSegmentToken>(-1, true));
+             makeToken<PassiveSegmentToken>(-1, true));
         paintBackSegment(0x696969);
       }
     }
@@ -261,16 +260,16 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
           takeAgentToken<ActiveSegmentToken>(nextAgentDir);
           passAgentToken<FinalSegmentCleanToken>
               (nextAgentDir,
-               std::make_shared<FinalSegmentCleanToken>(-1, true));
+               makeToken<FinalSegmentCleanToken>(-1, true));
         } else if (next != nullptr &&
                    !next->hasAgentToken<PassiveSegmentCleanToken>
                    (next->prevAgentDir)) {
           passAgentToken<PassiveSegmentCleanToken>
-              (nextAgentDir, std::make_shared<PassiveSegmentCleanToken>());
+              (nextAgentDir, makeToken<PassiveSegmentCleanToken>());
           passiveClean(true);
           generatedCleanToken = true;
           candidateParticle->putToken
-              (std::make_shared<ActiveSegmentCleanToken>(nextAgentDir));
+              (makeToken<ActiveSegmentCleanToken>(nextAgentDir));
           activeClean(true);
           absorbedActiveToken = true;
           isCoveredCandidate = true;
@@ -281,7 +280,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       } else {
         Q_ASSERT(false);
         passAgentToken<ActiveSegmentToken>
-            (prevAgentDir, std::make_shared<ActiveSegmentToken>());
+            (prevAgentDir, makeToken<ActiveSegmentToken>());
       }
     }
 
@@ -290,7 +289,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         passTokensDir == 1) {
       takeAgentToken<CandidacyAnnounceToken>(prevAgentDir);
       passAgentToken<CandidacyAckToken>
-          (prevAgentDir, std::make_shared<CandidacyAckToken>());
+          (prevAgentDir, makeToken<CandidacyAckToken>());
       paintBackSegment(0x696969);
       if (waitingForTransferAck) {
         gotAnnounceBeforeAck = true;
@@ -341,7 +340,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
               takeAgentToken<PassiveSegmentToken>(nextAgentDir)->isFinal;
           passAgentToken<ActiveSegmentToken>
               (prevAgentDir,
-               std::make_shared<ActiveSegmentToken>(-1, isFinalCheck));
+               makeToken<ActiveSegmentToken>(-1, isFinalCheck));
           if (isFinalCheck) {
             paintFrontSegment(0x696969);
           }
@@ -362,7 +361,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         return;
       } else if (!comparingSegment && passTokensDir == 0) {
         passAgentToken<SegmentLeadToken>
-            (nextAgentDir, std::make_shared<SegmentLeadToken>());
+            (nextAgentDir, makeToken<SegmentLeadToken>());
         paintFrontSegment(0xff0000);
         comparingSegment = true;
       }
@@ -381,16 +380,16 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         return;
       } else if (!waitingForTransferAck && passTokensDir == 0 && randBool()) {
         passAgentToken<CandidacyAnnounceToken>
-            (nextAgentDir, std::make_shared<CandidacyAnnounceToken>());
+            (nextAgentDir, makeToken<CandidacyAnnounceToken>());
         paintFrontSegment(0xffa500);
         waitingForTransferAck = true;
       }
     } else if (subPhase == SubPhase::SolitudeVerification) {
       if (!createdLead && passTokensDir == 0) {
         passAgentToken<SolitudeActiveToken>
-            (nextAgentDir, std::make_shared<SolitudeActiveToken>());
+            (nextAgentDir, makeToken<SolitudeActiveToken>());
         candidateParticle->putToken
-            (std::make_shared<SolitudePositiveXToken>(nextAgentDir, true));
+            (makeToken<SolitudePositiveXToken>(nextAgentDir, true));
         paintFrontSegment(0x00bfff);
         createdLead = true;
         hasGeneratedTokens = true;
@@ -458,7 +457,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       passAgentToken<SegmentLeadToken>
           (nextAgentDir, takeAgentToken<SegmentLeadToken>(prevAgentDir));
       candidateParticle->putToken(
-            std::make_shared<PassiveSegmentToken>(nextAgentDir, false));
+            makeToken<PassiveSegmentToken>(nextAgentDir, false));
       paintBackSegment(0xff0000);
       paintFrontSegment(0xff0000);
     }
@@ -476,7 +475,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       if (passTokensDir == 0 && !absorbedActiveToken) {
         if (takeAgentToken<ActiveSegmentToken>(nextAgentDir)->isFinal) {
           passAgentToken<FinalSegmentCleanToken>
-              (nextAgentDir, std::make_shared<FinalSegmentCleanToken>());
+              (nextAgentDir, makeToken<FinalSegmentCleanToken>());
         } else {
           absorbedActiveToken = true;
         }
@@ -638,7 +637,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
   } else if (agentState == State::SoleCandidate) {
     if (!testingBorder) {
       std::shared_ptr<BorderTestToken> token =
-          std::make_shared<BorderTestToken>(prevAgentDir, addNextBorder(0));
+          makeToken<BorderTestToken>(prevAgentDir, addNextBorder(0));
       passAgentToken(nextAgentDir, token);
       paintFrontSegment(-1);
       testingBorder = true;
@@ -753,13 +752,13 @@ generateSolitudeVectorTokens(std::pair<int, int> vector) {
   switch(vector.first) {
     case -1:
       candidateParticle->putToken
-          (std::make_shared<SolitudeNegativeXToken>(nextAgentDir, false));
+          (makeToken<SolitudeNegativeXToken>(nextAgentDir, false));
       break;
     case 0:
       break;
     case 1:
       candidateParticle->putToken
-          (std::make_shared<SolitudePositiveXToken>(nextAgentDir, false));
+          (makeToken<SolitudePositiveXToken>(nextAgentDir, false));
       break;
     default:
       Q_ASSERT(false);
@@ -768,13 +767,13 @@ generateSolitudeVectorTokens(std::pair<int, int> vector) {
   switch(vector.second) {
     case -1:
       candidateParticle->putToken
-          (std::make_shared<SolitudeNegativeYToken>(nextAgentDir, false));
+          (makeToken<SolitudeNegativeYToken>(nextAgentDir, false));
       break;
     case 0:
       break;
     case 1:
       candidateParticle->putToken
-          (std::make_shared<SolitudePositiveYToken>(nextAgentDir, false));
+          (makeToken<SolitudePositiveYToken>(nextAgentDir, false));
       break;
     default:
       Q_ASSERT(false);
@@ -1029,8 +1028,8 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
   Q_ASSERT(0 <= holeProb && holeProb <= 1);
 
   // Insert the seed at (0,0).
-  insert(new LeaderElectionParticle(Node(0, 0), -1, randDir(), *this,
-                                    LeaderElectionParticle::State::Idle));
+  emplace<LeaderElectionParticle>(Node(0, 0), -1, randDir(), *this,
+                                  LeaderElectionParticle::State::Idle);
   std::set<Node> occupied;
   occupied.insert(Node(0, 0));
 
@@ -1059,8 +1058,8 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
 
     // Add this candidate as a particle if not a hole.
     if (randBool(1.0 - holeProb)) {
-      insert(new LeaderElectionParticle(randomCandidate, -1, randDir(), *this,
-                                        LeaderElectionParticle::State::Idle));
+      emplace<LeaderElectionParticle>(randomCandidate, -1, randDir(), *this,
+                                      LeaderElectionParticle::State::Idle);
       ++numNonStaticParticles;
 
       // Add new candidates.
@@ -1076,18 +1075,13 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
 
 bool LeaderElectionSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
       return true;
     }
   #endif
 
-  for (auto p : particles) {
-    auto hp = dynamic_cast<LeaderElectionParticle*>(p);
-    if (hp->state != LeaderElectionParticle::State::Leader &&
-        hp->state != LeaderElectionParticle::State::Finished) {
-      return false;
-    }
-  }
-
-  return true;
+  using State = LeaderElectionParticle::State;
+  return numInTrackedState(static_cast<int>(State::Leader)) +
+         numInTrackedState(static_cast<int>(State::Finished)) ==
+         particles.size();
 }
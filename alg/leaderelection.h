@@ -34,8 +34,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class LeaderElectionParticle : public AmoebotParticle {
+class LeaderElectionParticle : public AmoebotParticleT<LeaderElectionParticle> {
  public:
   enum class State {
     Idle,
@@ -50,7 +51,8 @@ class LeaderElectionParticle : public AmoebotParticle {
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, and a system which it belongs to.
   LeaderElectionParticle(const Node head, const int globalTailDir,
-                         const int orientation, AmoebotSystem& system,
+                         const int orientation,
+                         AmoebotSystemT<LeaderElectionParticle>& system,
                          State state);
 
   // Executes one particle activation.
@@ -68,16 +70,14 @@ class LeaderElectionParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   virtual QString inspectionText() const;
 
+  // Returns this particle's state, so the system can count particles per state.
+  int trackedState() const override;
+
   // Returns the borderColors and borderPointColors arrays associated with the
   // particle to draw the boundaries for leader election.
   virtual std::array<int, 18> borderColors() const;
   virtual std::array<int, 6> borderPointColors() const;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  LeaderElectionParticle& nbrAtLabel(int label) const;
-
   // Returns the label associated with the direction which the next (resp.
   // previous) agent is according to the cycle that the agent is on (which is
   // determined by the provided agentDir parameter).
@@ -374,7 +374,7 @@ class LeaderElectionParticle : public AmoebotParticle {
    std::array<int, 6> borderPointColorLabels;
 };
 
-class LeaderElectionSystem : public AmoebotSystem {
+class LeaderElectionSystem : public AmoebotSystemT<LeaderElectionParticle> {
  public:
   // Constructs a system of LeaderElectionParticles with an optionally specified
   // size (#particles), and hole probability. holeProb in [0,1] controls how
@@ -17,8 +17,10 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class LeaderElectionByErosionParticle : public AmoebotParticle {
+class LeaderElectionByErosionParticle
+    : public AmoebotParticleT<LeaderElectionByErosionParticle> {
  public:
   enum class State {
     Null,       // Initial state.
@@ -29,7 +31,8 @@ class LeaderElectionByErosionParticle : public AmoebotParticle {
 
   // Constructs a new contracted, State::Null particle with a node position for
   // its head and a particle system it belongs to.
-  LeaderElectionByErosionParticle(const Node head, AmoebotSystem& system);
+  LeaderElectionByErosionParticle(
+      const Node head, AmoebotSystemT<LeaderElectionByErosionParticle>& system);
 
   // Executes one particle activation.
   void activate() override;
@@ -45,10 +48,12 @@ class LeaderElectionByErosionParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   QString inspectionText() const override;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  LeaderElectionByErosionParticle& nbrAtLabel(int label) const;
+  // Returns this particle's state, so the system can count particles per state.
+  int trackedState() const override;
+
+  // Returns true if this particle is eroded or the leader, as such particles
+  // never act again.
+  bool isQuiescent() const override;
 
   // Returns the label of the first port incident to a neighboring particle in
   // any of the specified states, starting at the (optionally) specified label
@@ -70,7 +75,8 @@ class LeaderElectionByErosionParticle : public AmoebotParticle {
   friend class LeaderElectionByErosionSystem;
 };
 
-class LeaderElectionByErosionSystem : public AmoebotSystem {
+class LeaderElectionByErosionSystem
+    : public AmoebotSystemT<LeaderElectionByErosionParticle> {
  public:
   // Constructs a system of LeaderElectionByErosionParticles with an optionally
   // specified size (#particles) in the shape of a hexagon, since this algorithm
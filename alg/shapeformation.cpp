@@ -6,12 +6,12 @@
 
 #include <QtGlobal>
 
-ShapeFormationParticle::ShapeFormationParticle(const Node head,
-                                               const int globalTailDir,
-                                               const int orientation,
-                                               AmoebotSystem& system,
-                                               State state, const QString mode)
-  : AmoebotParticle(head, globalTailDir, orientation, system),
+ShapeFormationParticle::ShapeFormationParticle(
+    const Node head, const int globalTailDir, const int orientation,
+    AmoebotSystemT<ShapeFormationParticle>& system, State state,
+    const QString mode)
+  : AmoebotParticleT<ShapeFormationParticle>(head, globalTailDir, orientation,
+                                             system),
     state(state),
     mode(mode),
     constructionDir(-1),
@@ -109,6 +109,14 @@ int ShapeFormationParticle::tailMarkColor() const {
   return headMarkColor();
 }
 
+int ShapeFormationParticle::trackedState() const {
+  return static_cast<int>(state);
+}
+
+bool ShapeFormationParticle::isQuiescent() const {
+  return state == State::Seed || state == State::Finish;
+}
+
 QString ShapeFormationParticle::inspectionText() const {
   QString text;
   text += "head: (" + QString::number(head.x) + ", " + QString::number(head.y) +
@@ -152,10 +160,6 @@ QString ShapeFormationParticle::inspectionText() const {
   return text;
 }
 
-ShapeFormationParticle& ShapeFormationParticle::nbrAtLabel(int label) const {
-  return AmoebotParticle::nbrAtLabel<ShapeFormationParticle>(label);
-}
-
 int ShapeFormationParticle::labelOfFirstNbrInState(
     std::initializer_list<State> states, int startLabel) const {
   auto prop = [&](const ShapeFormationParticle& p) {
@@ -309,8 +313,8 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
   // Insert the seed at (0,0).
   std::set<Node> occupied;
-  insert(new ShapeFormationParticle(Node(0, 0), -1, randDir(), *this,
-                                    ShapeFormationParticle::State::Seed, mode));
+  emplace<ShapeFormationParticle>(Node(0, 0), -1, randDir(), *this,
+                                  ShapeFormationParticle::State::Seed, mode);
   occupied.insert(Node(0, 0));
 
   std::set<Node> candidates;
@@ -336,9 +340,9 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new ShapeFormationParticle(randCand, -1, randDir(), *this,
-                                        ShapeFormationParticle::State::Idle,
-                                        mode));
+      emplace<ShapeFormationParticle>(randCand, -1, randDir(), *this,
+                                      ShapeFormationParticle::State::Idle,
+                                      mode);
       occupied.insert(randCand);
       particlesAdded++;
 
@@ -354,20 +358,15 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
 bool ShapeFormationSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
       return true;
     }
   #endif
 
-  for (auto p : particles) {
-    auto hp = dynamic_cast<ShapeFormationParticle*>(p);
-    if (hp->state != ShapeFormationParticle::State::Seed &&
-        hp->state != ShapeFormationParticle::State::Finish) {
-      return false;
-    }
-  }
-
-  return true;
+  using State = ShapeFormationParticle::State;
+  return numInTrackedState(static_cast<int>(State::Seed)) +
+         numInTrackedState(static_cast<int>(State::Finish)) ==
+         particles.size();
 }
 
 std::set<QString> ShapeFormationSystem::getAcceptedModes() {
@@ -22,8 +22,9 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebot.h"
 
-class ShapeFormationParticle : public AmoebotParticle {
+class ShapeFormationParticle : public AmoebotParticleT<ShapeFormationParticle> {
  public:
   enum class State {
     Seed,
@@ -38,7 +39,8 @@ class ShapeFormationParticle : public AmoebotParticle {
   // for its local compass, a system which it belongs to, an initial state, and
   // a string to determine what shape to form.
   ShapeFormationParticle(const Node head, const int globalTailDir,
-                         const int orientation, AmoebotSystem& system,
+                         const int orientation,
+                         AmoebotSystemT<ShapeFormationParticle>& system,
                          State state, const QString mode);
 
   // Executes one particle activation.
@@ -57,10 +59,12 @@ class ShapeFormationParticle : public AmoebotParticle {
   // to snapshot the current values of this particle's memory at runtime.
   virtual QString inspectionText() const;
 
-  // Gets a reference to the neighboring particle incident to the specified port
-  // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
-  ShapeFormationParticle& nbrAtLabel(int label) const;
+  // Returns this particle's state, so the system can count particles per state.
+  int trackedState() const override;
+
+  // Returns true if this particle is the seed or finished, as such particles
+  // never act again.
+  bool isQuiescent() const override;
 
   // Returns the label of the first port incident to a neighboring particle in
   // any of the specified states, starting at the (optionally) specified label
@@ -103,7 +107,7 @@ class ShapeFormationParticle : public AmoebotParticle {
   friend class ShapeFormationSystem;
 };
 
-class ShapeFormationSystem : public AmoebotSystem  {
+class ShapeFormationSystem : public AmoebotSystemT<ShapeFormationParticle>  {
  public:
   // Constructs a system of ShapeFormationParticles with an optionally specified
   // size (#particles), hole probability, and shape to form. holeProb in [0,1]
@@ -0,0 +1,54 @@
+# Command-line benchmarks for the simulator core. These link only against
+# QtCore and do not start the GUI.
+
+QT      = core
+CONFIG  += c++11 console
+CONFIG  -= app_bundle
+TARGET    = occupancybench
+TEMPLATE  = app
+
+INCLUDEPATH += ..
+
+HEADERS += \
+    ../core/amoebotparticle.h \
+    ../core/amoebotsystem.h \
+    ../core/connectivitymonitor.h \
+    ../core/densitymap.h \
+    ../core/immoparticle.h \
+    ../core/labelset.h \
+    ../core/localparticle.h \
+    ../core/metric.h \
+    ../core/node.h \
+    ../core/nodehashmap.h \
+    ../core/occupancyindex.h \
+    ../core/particle.h \
+    ../core/particlearena.h \
+    ../core/particlepositions.h \
+    ../core/rendersnapshot.h \
+    ../core/scheduler.h \
+    ../core/system.h \
+    ../core/tilegrid.h \
+    ../core/tokenstore.h \
+    ../core/typedamoebot.h \
+    ../helper/philox.h \
+    ../helper/randomnumbergenerator.h
+
+SOURCES += \
+    occupancybench.cpp \
+    ../core/amoebotparticle.cpp \
+    ../core/amoebotsystem.cpp \
+    ../core/connectivitymonitor.cpp \
+    ../core/densitymap.cpp \
+    ../core/immoparticle.cpp \
+    ../core/localparticle.cpp \
+    ../core/metric.cpp \
+    ../core/occupancyindex.cpp \
+    ../core/particle.cpp \
+    ../core/particlearena.cpp \
+    ../core/particlepositions.cpp \
+    ../core/rendersnapshot.cpp \
+    ../core/scheduler.cpp \
+    ../core/system.cpp \
+    ../core/tilegrid.cpp \
+    ../core/tokenstore.cpp \
+    ../helper/randomnumbergenerator.cpp
@@ -0,0 +1,103 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Measures particle activations per second for each occupancy index backend
+// (see core/occupancyindex.h) on systems of 10^3 to 10^6 particles, once with
+// neighbors looked up in the index and once with the adjacency cache (see
+// AmoebotSystem::setAdjacencyCached). Every particle performs a random walk: a
+// contracted particle tries to expand in a random direction and an expanded
+// particle counts the neighbors of its head and tail and contracts onto the
+// side with more of them (breaking ties at random), so each activation
+// exercises canExpand, expand, hasNbrAtLabel, and contract. The last column is
+// the system's memory usage (see AmoebotSystem::memoryUsage) divided by the
+// number of particles.
+//
+// Usage: occupancybench [maxParticles = 1000000] [activationsPerRun = 2000000]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/amoebotparticle.h"
+#include "core/amoebotsystem.h"
+
+class RandomWalkParticle : public AmoebotParticle {
+ public:
+  RandomWalkParticle(const Node& head, AmoebotSystem& system)
+    : AmoebotParticle(head, -1, randDir(), system) {}
+
+  void activate() override {
+    if (isContracted()) {
+      const int label = randDir();
+      if (canExpand(label)) {
+        expand(label);
+      }
+    } else {
+      int numHeadNbrs = 0;
+      for (const int label : headLabels()) {
+        numHeadNbrs += hasNbrAtLabel(label) ? 1 : 0;
+      }
+      int numTailNbrs = 0;
+      for (const int label : tailLabels()) {
+        numTailNbrs += hasNbrAtLabel(label) ? 1 : 0;
+      }
+
+      if (numHeadNbrs > numTailNbrs
+          || (numHeadNbrs == numTailNbrs && randBool())) {
+        contractTail();
+      } else {
+        contractHead();
+      }
+    }
+  }
+};
+
+class RandomWalkSystem : public AmoebotSystem {
+ public:
+  // Places the particles on every other node of a square patch of the lattice,
+  // leaving room for them to move.
+  RandomWalkSystem(int numParticles, OccupancyIndex::Backend backend)
+    : AmoebotSystem(backend) {
+    const int side = static_cast<int>(std::ceil(std::sqrt(numParticles)));
+    for (int i = 0; i < numParticles; ++i) {
+      emplace<RandomWalkParticle>(Node(2 * (i % side), 2 * (i / side)),
+                                  *this);
+    }
+  }
+};
+
+int main(int argc, char* argv[]) {
+  const long maxParticles = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  const long numActivations = (argc > 2) ? std::atol(argv[2]) : 2000000;
+
+  std::printf("%-10s %-10s %12s %16s %16s\n", "backend", "neighbors",
+              "particles", "activations/s", "bytes/particle");
+  for (long n = 1000; n <= maxParticles; n *= 10) {
+    for (auto backend : {OccupancyIndex::Backend::Ordered,
+                         OccupancyIndex::Backend::Hashed,
+                         OccupancyIndex::Backend::Tiled}) {
+      for (bool cached : {false, true}) {
+        RandomWalkSystem system(n, backend);
+        system.finishConstruction();
+        system.setAdjacencyCached(cached);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < numActivations; ++i) {
+          system.activate();
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        std::printf("%-10s %-10s %12ld %16.0f %16.1f\n",
+                    OccupancyIndex::backendName(backend).toUtf8().constData(),
+                    cached ? "cached" : "lookup", n,
+                    numActivations / elapsed.count(),
+                    static_cast<double>(system.memoryUsage().totalBytes()) / n);
+      }
+    }
+  }
+
+  return 0;
+}
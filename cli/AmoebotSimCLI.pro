@@ -0,0 +1,16 @@
+# Headless command-line runner. Links the simulation core, the algorithms, and
+# the script engine against QtCore and QtQml only; no window, render loop, or
+# QML scene is created.
+
+QT      = core qml
+CONFIG  += c++11 console
+CONFIG  -= app_bundle
+TARGET    = AmoebotSimCLI
+TEMPLATE  = app
+
+DEFINES += AMOEBOTSIM_HEADLESS
+
+include(../AmoebotSim.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,293 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Headless entry point. Runs either a script file or a single algorithm
+// instance without creating a window, render loop, or QML scene:
+//
+//   AmoebotSimCLI path/to/script.js
+//   AmoebotSimCLI [-n maxActivations] [-o metrics.json] signature [params...]
+//   AmoebotSimCLI -t trials [-j threads] [-n ...] [-r ...] signature [params...]
+//
+// With -s/--seed, an algorithm run uses the given random seed, and trial i of a
+// parallel run uses RandomStream::splitSeed(seed, i); without it, a base seed
+// is drawn at random and reported so the run can be reproduced. --rng philox
+// selects the counter-based random engine for all systems, --scheduler selects
+// their activation scheduler (see core/scheduler.h), and --skip-quiescent makes
+// them skip quiescent particles (see AmoebotSystem::setQuiescentSkipped).
+// --check-interval k
+// evaluates hasTerminated only after every k-th activation, or once per round
+// for k = 0 (see System::setTerminationCheckInterval). --memory-report writes
+// the memory report of an algorithm run to standard error once it finishes.
+//
+// In the second form, the algorithm with the given signature (e.g.,
+// "shapeformation") is instantiated with the given parameters, in the order
+// they appear in the algorithm's instantiate() slot, and run until termination
+// or until the activation limit is reached. Its metrics JSON is then written to
+// the given file or to standard output. The third form runs independent trials
+// of the algorithm in parallel (see core/trialrunner.h) and writes the metrics
+// of all trials as one JSON document.
+
+#include <cstdio>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include "core/amoebotsystem.h"
+#include "core/scheduler.h"
+#include "core/simulator.h"
+#include "core/system.h"
+#include "core/trialrunner.h"
+#include "helper/randomnumbergenerator.h"
+#include "script/scriptengine.h"
+#include "ui/algorithm.h"
+
+// Returns the given command line parameter as a JavaScript literal: numbers are
+// passed through and everything else is quoted as a string.
+QString toScriptLiteral(const QString& param) {
+  bool isNumber = false;
+  param.toDouble(&isNumber);
+  if (isNumber) {
+    return param;
+  }
+  QString escaped = param;
+  escaped.replace("\\", "\\\\").replace("\"", "\\\"");
+  return "\"" + escaped + "\"";
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("AmoebotSimCLI");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Runs AmoebotSim scripts and algorithms "
+                                   "without the GUI.");
+  parser.addHelpOption();
+  QCommandLineOption maxActivationsOption(
+      QStringList() << "n" << "max-activations",
+      "Stop an algorithm run after at most <count> activations.", "count");
+  QCommandLineOption metricsOption(
+      QStringList() << "o" << "metrics",
+      "Write the metrics JSON of an algorithm run to <file> instead of "
+      "standard output.", "file");
+  QCommandLineOption maxRoundsOption(
+      QStringList() << "r" << "max-rounds",
+      "Stop each trial after at most <count> rounds.", "count");
+  QCommandLineOption trialsOption(
+      QStringList() << "t" << "trials",
+      "Run <count> independent trials of the algorithm in parallel.", "count");
+  QCommandLineOption threadsOption(
+      QStringList() << "j" << "threads",
+      "Use <count> worker threads for trials (default: one per core).",
+      "count");
+  QCommandLineOption seedOption(
+      QStringList() << "s" << "seed",
+      "Seed the run (or the base seed of all trials) with <seed>.", "seed");
+  QCommandLineOption rngOption(
+      QStringList() << "rng",
+      "Use the random engine <engine>: mt19937 (default) or philox.",
+      "engine");
+  QCommandLineOption schedulerOption(
+      QStringList() << "scheduler",
+      "Activate particles using the scheduler <policy>: uniform (default), "
+      "permutation, sweep, or poisson.", "policy");
+  QCommandLineOption skipQuiescentOption(
+      QStringList() << "skip-quiescent",
+      "Skip the activations of quiescent particles instead of running them.");
+  QCommandLineOption checkIntervalOption(
+      QStringList() << "check-interval",
+      "Check for termination after every <k>-th activation, or once per round "
+      "if <k> is 0 (default: 1).", "k");
+  parser.addOption(maxActivationsOption);
+  parser.addOption(maxRoundsOption);
+  parser.addOption(metricsOption);
+  parser.addOption(trialsOption);
+  parser.addOption(threadsOption);
+  parser.addOption(seedOption);
+  parser.addOption(rngOption);
+  parser.addOption(schedulerOption);
+  parser.addOption(skipQuiescentOption);
+  QCommandLineOption memoryReportOption(
+      QStringList() << "memory-report",
+      "Write the memory report of an algorithm run to standard error.");
+  parser.addOption(checkIntervalOption);
+  parser.addOption(memoryReportOption);
+  parser.addPositionalArgument("target", "A script file (.js) or an algorithm "
+                               "signature.");
+  parser.addPositionalArgument("params", "Algorithm parameters, in order.",
+                               "[params...]");
+  parser.process(app);
+
+  const QStringList args = parser.positionalArguments();
+  if (args.isEmpty()) {
+    parser.showHelp(1);
+  }
+
+  QTextStream err(stderr);
+  Simulator sim;
+  AlgorithmList algorithms;
+  ScriptEngine scriptEngine(sim, nullptr, &algorithms);
+  QObject::connect(&scriptEngine, &ScriptEngine::log,
+                   [&err](const QString msg, const bool isError) {
+                     err << (isError ? "error: " : "") << msg << "\n";
+                     err.flush();
+                   });
+  for (Algorithm* alg : algorithms.getAlgs()) {
+    QObject::connect(alg, &Algorithm::log,
+                     [&err](const QString msg, const bool isError) {
+                       err << (isError ? "error: " : "") << msg << "\n";
+                       err.flush();
+                     });
+    QObject::connect(alg, &Algorithm::setSystem, &sim, &Simulator::setSystem);
+  }
+
+  // Script mode: the script drives the simulator itself.
+  const QString target = args.first();
+  if (target.endsWith(".js") || QFileInfo(target).isFile()) {
+    scriptEngine.runScript(target);
+    return 0;
+  }
+
+  // Algorithm mode: instantiate the algorithm through its script command so
+  // that parameters are converted exactly as they are for scripts.
+  bool isKnown = false;
+  for (Algorithm* alg : algorithms.getAlgs()) {
+    isKnown = isKnown || alg->getSignature() == target;
+  }
+  if (!isKnown) {
+    err << "error: unknown algorithm signature '" << target << "'; expected "
+        << "one of:\n";
+    for (Algorithm* alg : algorithms.getAlgs()) {
+      err << "  " << alg->getSignature() << " ("
+          << alg->getParameterNames().join(", ") << ")\n";
+    }
+    return 1;
+  }
+
+  bool ok = true;
+  TrialRunner::Budget budget;
+  if (parser.isSet(maxActivationsOption)) {
+    budget.maxActivations =
+        parser.value(maxActivationsOption).toULongLong(&ok);
+  }
+  if (ok && parser.isSet(maxRoundsOption)) {
+    budget.maxRounds = parser.value(maxRoundsOption).toULongLong(&ok);
+  }
+  if (ok && parser.isSet(checkIntervalOption)) {
+    budget.terminationCheckInterval =
+        parser.value(checkIntervalOption).toUInt(&ok);
+    sim.setTerminationCheckInterval(budget.terminationCheckInterval);
+  }
+  int numTrials = 0;
+  if (ok && parser.isSet(trialsOption)) {
+    numTrials = parser.value(trialsOption).toInt(&ok);
+    ok = ok && numTrials > 0;
+  }
+  int numThreads = 0;
+  if (ok && parser.isSet(threadsOption)) {
+    numThreads = parser.value(threadsOption).toInt(&ok);
+  }
+  uint64_t seed = RandomStream::entropySeed();
+  if (ok && parser.isSet(seedOption)) {
+    seed = parser.value(seedOption).toULongLong(&ok);
+  }
+  if (!ok) {
+    err << "error: invalid numeric option\n";
+    return 1;
+  }
+  if (parser.isSet(rngOption)) {
+    const QString engine = parser.value(rngOption);
+    if (engine != "mt19937" && engine != "philox") {
+      err << "error: unknown random engine '" << engine << "'\n";
+      return 1;
+    }
+    RandomStream::setDefaultEngine(
+        RandomStream::engineFromName(engine.toStdString()));
+  }
+  if (parser.isSet(schedulerOption)) {
+    const QString scheduler = parser.value(schedulerOption);
+    if (!Scheduler::isPolicyName(scheduler)) {
+      err << "error: unknown scheduler '" << scheduler << "'\n";
+      return 1;
+    }
+    Scheduler::setDefaultPolicy(Scheduler::policyFromName(scheduler));
+  }
+  if (parser.isSet(skipQuiescentOption)) {
+    AmoebotSystem::setQuiescentSkippedByDefault(true);
+  }
+
+  const QStringList params = args.mid(1);
+  QString json;
+  if (numTrials > 0) {
+    // Each trial instantiates the algorithm through its own algorithm list,
+    // created on the trial's worker thread, so that no QObject is shared
+    // between threads.
+    TrialRunner::SystemFactory factory = [&target, &params, seed](int trial) {
+      RandomStream::setNextSeed(RandomStream::splitSeed(seed, trial));
+      AlgorithmList trialAlgorithms;
+      std::shared_ptr<System> system;
+      for (Algorithm* alg : trialAlgorithms.getAlgs()) {
+        if (alg->getSignature() == target) {
+          QObject::connect(alg, &Algorithm::setSystem,
+                           [&system](std::shared_ptr<System> created) {
+                             system = created;
+                           });
+          QObject::connect(alg, &Algorithm::log,
+                           [](const QString msg, const bool isError) {
+                             if (isError) {
+                               qWarning("error: %s", qPrintable(msg));
+                             }
+                           });
+          alg->instantiateWith(params);
+        }
+      }
+      return system;
+    };
+    TrialRunner runner(numThreads);
+    err << "running " << numTrials << " trials on " << runner.numThreads()
+        << " threads with base seed " << seed << "\n";
+    err.flush();
+    json = runner.run(factory, numTrials, budget);
+  } else {
+    QStringList literals;
+    for (const QString& param : params) {
+      literals << toScriptLiteral(param);
+    }
+    RandomStream::setNextSeed(seed);
+    scriptEngine.runCommand(target + "(" + literals.join(", ") + ")");
+    if (budget.maxActivations > 0 || budget.maxRounds > 0) {
+      QMutexLocker locker(&sim.getSystem()->mutex);
+      TrialRunner::runTrial(*sim.getSystem(), budget);
+    } else {
+      sim.runUntilTermination();
+    }
+    json = sim.getSystem()->metricsAsJSON();
+    if (parser.isSet(memoryReportOption)) {
+      err << sim.memoryReport() << "\n";
+      err.flush();
+    }
+  }
+
+  if (parser.isSet(metricsOption)) {
+    QFile outFile(parser.value(metricsOption));
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+      err << "error: could not write to " << parser.value(metricsOption)
+          << "\n";
+      return 1;
+    }
+    QTextStream outStream(&outFile);
+    outStream << json;
+  } else {
+    QTextStream out(stdout);
+    out << json << "\n";
+  }
+
+  return 0;
+}
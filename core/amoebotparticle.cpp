@@ -4,10 +4,23 @@
 
 #include "core/amoebotparticle.h"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 AmoebotParticle::AmoebotParticle(const Node& head, int globalTailDir,
                                  const int orientation, AmoebotSystem& system)
   : LocalParticle(head, globalTailDir, orientation),
-    system(system) {}
+    system(system),
+    _index(0),
+    _activationEpoch(0),
+    _id(0),
+    _numActivations(0),
+    _trackedState(-1),
+    _arenaBytes(0),
+    _quiescent(false),
+    _scheduleIndex(0),
+    _nbrs() {}
 
 AmoebotParticle::~AmoebotParticle() {}
 
@@ -25,6 +38,14 @@ int AmoebotParticle::tailMarkGlobalDir() const {
   return (dir == -1) ? -1 : localToGlobalDir(dir);
 }
 
+int AmoebotParticle::trackedState() const {
+  return -1;
+}
+
+bool AmoebotParticle::isQuiescent() const {
+  return false;
+}
+
 int AmoebotParticle::headMarkDir() const {
   return -1;
 }
@@ -36,7 +57,8 @@ int AmoebotParticle::tailMarkDir() const {
 bool AmoebotParticle::canExpand(int label) const {
   Q_ASSERT(0 <= label && label < 6);
 
-  return (isContracted() && !hasNbrAtLabel(label) && !hasObjectAtLabel(label));
+  return isContracted() &&
+         !system.occupancy.isOccupied(nbrNodeReachedViaLabel(label));
 }
 
 void AmoebotParticle::expand(int label) {
@@ -45,7 +67,14 @@ void AmoebotParticle::expand(int label) {
   const int globalExpansionDir = localToGlobalDir(label);
   head = head.nodeInDir(globalExpansionDir);
   globalTailDir = (globalExpansionDir + 3) % 6;
-  system.particleMap[head] = this;
+  syncPosition();
+  system.occupancy.setParticle(head, this);
+  system.connectivity.nodeOccupied(head);
+  if (system._adjacencyCached) {
+    // The old head is the new tail.
+    std::copy(std::begin(_nbrs[0]), std::end(_nbrs[0]), _nbrs[1]);
+    system.linkNode(this, head);
+  }
 
   system.registerMovement();
 }
@@ -66,12 +95,21 @@ void AmoebotParticle::push(int label) {
 
   head = handoverNode;
   globalTailDir = (globalExpansionDir + 3) % 6;
-  system.particleMap[handoverNode] = this;
+  syncPosition();
+  system.occupancy.setParticle(handoverNode, this);
 
   if (handoverNode == neighbor.head) {
     neighbor.head = neighbor.tail();
+    // The neighbor's tail is its new head.
+    std::copy(std::begin(neighbor._nbrs[1]), std::end(neighbor._nbrs[1]),
+              neighbor._nbrs[0]);
   }
   neighbor.globalTailDir = -1;
+  neighbor.syncPosition();
+  if (system._adjacencyCached) {
+    std::copy(std::begin(_nbrs[0]), std::end(_nbrs[0]), _nbrs[1]);
+    system.linkNode(this, handoverNode);
+  }
 
   system.registerMovement(2);
   system.registerActivation(&neighbor);
@@ -87,9 +125,16 @@ void AmoebotParticle::contract(int label) {
 void AmoebotParticle::contractHead() {
   Q_ASSERT(isExpanded());
 
-  system.particleMap.erase(head);
+  const Node oldHead = head;
+  system.occupancy.eraseParticle(head);
+  system.connectivity.nodeFreed(head);
   head = tail();
   globalTailDir = -1;
+  syncPosition();
+  if (system._adjacencyCached) {
+    std::copy(std::begin(_nbrs[1]), std::end(_nbrs[1]), _nbrs[0]);
+    system.unlinkNode(oldHead);
+  }
 
   system.registerMovement();
 }
@@ -97,8 +142,14 @@ void AmoebotParticle::contractHead() {
 void AmoebotParticle::contractTail() {
   Q_ASSERT(isExpanded());
 
-  system.particleMap.erase(tail());
+  const Node oldTail = tail();
+  system.occupancy.eraseParticle(oldTail);
+  system.connectivity.nodeFreed(oldTail);
   globalTailDir = -1;
+  syncPosition();
+  if (system._adjacencyCached) {
+    system.unlinkNode(oldTail);
+  }
 
   system.registerMovement();
 }
@@ -119,12 +170,22 @@ void AmoebotParticle::pull(int label) {
 
   if (isHeadLabel(label)) {
     head = tail();
+    // This particle's tail is its new head.
+    std::copy(std::begin(_nbrs[1]), std::end(_nbrs[1]), _nbrs[0]);
   }
 
   globalTailDir = -1;
+  syncPosition();
   neighbor.head = handoverNode;
   neighbor.globalTailDir = globalPullDir;
-  system.particleMap[handoverNode] = &neighbor;
+  neighbor.syncPosition();
+  system.occupancy.setParticle(handoverNode, &neighbor);
+  if (system._adjacencyCached) {
+    // The neighbor's old node is its new tail.
+    std::copy(std::begin(neighbor._nbrs[0]), std::end(neighbor._nbrs[0]),
+              neighbor._nbrs[1]);
+    system.linkNode(&neighbor, handoverNode);
+  }
 
   system.registerMovement(2);
   system.registerActivation(&neighbor);
@@ -134,13 +195,30 @@ void AmoebotParticle::makeHeadLabel(int label) {
     if (isExpanded() && !isHeadLabel(label)) {
         head = tail();
         globalTailDir = (globalTailDir + 3) % 6;
+        syncPosition();
+        std::swap(_nbrs[0], _nbrs[1]);
     }
 }
 
 
 bool AmoebotParticle::hasNbrAtLabel(int label) const {
-  const Node neighboringNode = nbrNodeReachedViaLabel(label);
-  return system.particleMap.find(neighboringNode) != system.particleMap.end();
+  return nbrParticleAtLabel(label) != nullptr;
+}
+
+LabelSet AmoebotParticle::occupiedLabels() const {
+  const LabelSet unique = uniqueLabelSet();
+  const int labelLimit = isContracted() ? 6 : 10;
+  LabelSet occupied;
+  for (int label = 0; label < labelLimit; ++label) {
+    // A label that is not unique reaches the same node as the previous label
+    // (see uniqueLabelSet), which is never label 0.
+    if (unique.contains(label) ? nbrParticleAtLabel(label) != nullptr
+                               : occupied.contains(label - 1)) {
+      occupied.insert(label);
+    }
+  }
+
+  return occupied;
 }
 
 bool AmoebotParticle::hasHeadAtLabel(int label) {
@@ -163,7 +241,7 @@ bool AmoebotParticle::hasTailAtLabel(int label) {
 
 bool AmoebotParticle::hasObjectAtLabel(int label) const {
   const Node neighboringNode = nbrNodeReachedViaLabel(label);
-  return system.immoparticleMap.find(neighboringNode) != system.immoparticleMap.end();
+  return system.occupancy.objectAt(neighboringNode) != nullptr;
 }
 
 bool AmoebotParticle::hasObjectNbr() const {
@@ -183,7 +261,7 @@ int AmoebotParticle::labelOfFirstObjectNbr(int startLabel) const {
 }
 
 void AmoebotParticle::putToken(std::shared_ptr<Token> token) {
-  tokens.push_back(token);
+  tokens.put(std::move(token));
 }
 
 int AmoebotSystem::seedOrientation() const {
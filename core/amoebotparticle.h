@@ -13,7 +13,8 @@
 #ifndef AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
 #define AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
 
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -21,6 +22,7 @@
 #include "core/amoebotsystem.h"
 #include "core/localparticle.h"
 #include "core/node.h"
+#include "core/tokenstore.h"
 #include "helper/randomnumbergenerator.h"
 
 class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
@@ -44,6 +46,25 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   // return true if the particle is in an error state.
   virtual bool isErrorParticle() const { return false;}
 
+  // Returns the state under which this particle is counted in its system's
+  // state populations (see AmoebotSystem::numInTrackedState), or -1 if it is
+  // not counted. Algorithms whose termination only depends on how many
+  // particles are in certain states override this (typically returning the
+  // particle's state enum as an int) so that hasTerminated can compare counters
+  // instead of scanning all particles. The default returns -1.
+  virtual int trackedState() const;
+
+  // Returns true if activating this particle cannot change the system: the
+  // activation would neither move any particle nor change any particle's
+  // memory. While the system skips quiescent particles (see
+  // AmoebotSystem::setQuiescentSkipped), it only activates particles that are
+  // not quiescent. Like trackedState, the system re-evaluates this after every
+  // activation for the activated particle only, so it should depend on this
+  // particle's own memory (see AmoebotSystem::refreshQuiescence otherwise).
+  // Algorithms override this for states in which particles never act again
+  // (e.g., retired or finished particles). The default returns false.
+  virtual bool isQuiescent() const;
+
   // Returns the global direction from the head (respectively, tail) on which to
   // draw the direction markers (-1 indicates no marker). Meant to provide info
   // to the visualization and should not be called by any particle algorithms.
@@ -96,6 +117,12 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   template<class ParticleType>
   ParticleType& nbrAtLabel(int label) const;
 
+  // Returns the neighboring particle incident to the specified port label, or
+  // nullptr if there is none. While the system caches adjacency (see
+  // AmoebotSystem::setAdjacencyCached), this is a single load from _nbrs;
+  // otherwise, it looks up the neighboring node in the occupancy index.
+  AmoebotParticle* nbrParticleAtLabel(int label) const;
+
   // Functions for checking the existence of a neighboring particle (or more
   // specifically, a neighboring particle's head or tail) in the position
   // incident to the given port.
@@ -103,6 +130,12 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   bool hasHeadAtLabel(int label);
   bool hasTailAtLabel(int label);
 
+  // Returns the set of all labels (6 if contracted, 10 if expanded) incident to
+  // a neighboring particle. Each neighboring node is looked up only once, so
+  // this is cheaper than calling hasNbrAtLabel for every label; intersect the
+  // result with, e.g., headLabelSet() to restrict it to certain labels.
+  LabelSet occupiedLabels() const;
+
   // Function for checking the existence of a neighboring object
   bool hasObjectAtLabel(int label) const;
   bool hasObjectNbr() const;
@@ -124,7 +157,7 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
 
   // A struct expressing the most basic version of a token. Particle subclasses
   // using tokens should write their token structs to inherit from this one.
-  struct Token { virtual ~Token(){ } };
+  using Token = TokenStore::Token;
 
   // Functions for handling tokens. putToken adds the given token reference to
   // this particle's collection. peekAtToken returns a reference to the first
@@ -132,7 +165,12 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   // takeToken does the same thing as peekAtToken, but additionally removes the
   // returned reference from this particle's collection. Note that peekAtToken
   // and takeToken both fail when no token of the given type exists in the
-  // collection; consider using hasToken() first if unsure.
+  // collection; consider using hasToken() first if unsure. Tokens are kept in
+  // one queue per token type (see tokenstore.h). Tokens matching a query are
+  // still returned in the order they were put, even across token types, and
+  // queries for a token type do not inspect tokens of unrelated types. makeToken creates a token like
+  // std::make_shared, but from a pool that reuses the memory of released
+  // tokens.
   void putToken(std::shared_ptr<Token> token);
   template<class TokenType>
   std::shared_ptr<TokenType> peekAtToken() const;
@@ -164,21 +202,90 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   template<class TokenType>
   bool hasToken(std::function<bool(const std::shared_ptr<TokenType>)>
                 propertyCheck) const;
+  template<class TokenType, class... Args>
+  static std::shared_ptr<TokenType> makeToken(Args&&... args);
 
   AmoebotSystem& system;
 
  private:
-  std::deque<std::shared_ptr<Token>> tokens;
+  friend class AmoebotSystem;
+
+  // Copies this particle's head and tail direction into its system's position
+  // arrays; called by every movement function after it changes them.
+  void syncPosition();
+
+  // Adapts a property check on tokens of the given type to the predicates used
+  // by the token store.
+  template<class TokenType>
+  struct TokenProperty {
+    bool operator()(const std::shared_ptr<Token>& token) const {
+      return check(std::static_pointer_cast<TokenType>(token));
+    }
+
+    const std::function<bool(const std::shared_ptr<TokenType>)>& check;
+  };
+
+  TokenStore tokens;
+
+  // This particle's position in its system's particle list, maintained by the
+  // system so that removals do not have to search for the particle.
+  unsigned int _index;
+
+  // The system epoch (round) in which this particle was last activated; used
+  // by the system to detect the end of a round.
+  unsigned int _activationEpoch;
+
+  // This particle's id, assigned by the system in insertion order and never
+  // reused, and the number of times it has been activated. Together they key
+  // the random draws of each activation under the Philox engine.
+  uint32_t _id;
+  unsigned long long _numActivations;
+
+  // The tracked state this particle is currently counted under in its system's
+  // state populations, or -1.
+  int _trackedState;
+
+  // The size of the block this particle occupies in its system's arena, or 0 if
+  // it was allocated with new; see AmoebotSystem::emplace.
+  std::size_t _arenaBytes;
+
+  // Whether this particle is quiescent, and its position in its system's list
+  // of enabled or quiescent particles; only maintained while the system skips
+  // quiescent particles.
+  bool _quiescent;
+  unsigned int _scheduleIndex;
+
+  // The particles occupying the neighbors of this particle's head (_nbrs[0])
+  // and tail (_nbrs[1]) nodes, indexed by global direction; nullptr marks an
+  // unoccupied neighbor, and the slot pointing from the head to the tail (or
+  // vice versa) holds this particle. Only valid while the system caches
+  // adjacency; _nbrs[1] is unused while this particle is contracted.
+  AmoebotParticle* _nbrs[2][6];
 };
 
+inline void AmoebotParticle::syncPosition() {
+  system._positions.update(_index, head, globalTailDir);
+}
+
+inline AmoebotParticle* AmoebotParticle::nbrParticleAtLabel(int label) const {
+  if (system._adjacencyCached) {
+    if (isContracted()) {
+      Q_ASSERT(0 <= label && label < 6);
+      return _nbrs[0][localToGlobalDir(label)];
+    }
+    return _nbrs[headLabelSet().contains(label) ? 0 : 1]
+                [labelToGlobalDir(label)];
+  }
+
+  return system.occupancy.particleAt(nbrNodeReachedViaLabel(label));
+}
+
 template<class ParticleType>
 ParticleType& AmoebotParticle::nbrAtLabel(int label) const {
-  Node nbrNode = nbrNodeReachedViaLabel(label);
-  auto it = system.particleMap.find(nbrNode);
-  Q_ASSERT(it != system.particleMap.end() &&
-           dynamic_cast<ParticleType*>(it->second) != nullptr);
+  AmoebotParticle* nbr = nbrParticleAtLabel(label);
+  Q_ASSERT(nbr != nullptr && dynamic_cast<ParticleType*>(nbr) != nullptr);
 
-  return dynamic_cast<ParticleType&>(*(it->second));
+  return dynamic_cast<ParticleType&>(*nbr);
 }
 
 template<class ParticleType>
@@ -205,108 +312,63 @@ int AmoebotParticle::labelOfFirstNbrWithProperty(
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::peekAtToken() const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token =
+      tokens.peek<TokenType>(TokenStore::AnyToken());
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::peekAtToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token =
+      tokens.peek<TokenType>(TokenProperty<TokenType>{propertyCheck});
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::takeToken() {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      std::swap(tokens[0], tokens[i]);
-      tokens.pop_front();
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token =
+      tokens.take<TokenType>(TokenStore::AnyToken());
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::takeToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      std::swap(tokens[0], tokens[i]);
-      tokens.pop_front();
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token =
+      tokens.take<TokenType>(TokenProperty<TokenType>{propertyCheck});
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 int AmoebotParticle::countTokens() const {
-  int count = 0;
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      count++;
-    }
-  }
-  return count;
+  return tokens.count<TokenType>(TokenStore::AnyToken());
 }
 
 template<class TokenType>
 int AmoebotParticle::countTokens(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  int count = 0;
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      count++;
-    }
-  }
-  return count;
+  return tokens.count<TokenType>(TokenProperty<TokenType>{propertyCheck});
 }
 
 template<class TokenType>
 bool AmoebotParticle::hasToken() const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      return true;
-    }
-  }
-  return false;
+  return tokens.has<TokenType>(TokenStore::AnyToken());
 }
 
 template<class TokenType>
 bool AmoebotParticle::hasToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      return true;
-    }
-  }
-  return false;
+  return tokens.has<TokenType>(TokenProperty<TokenType>{propertyCheck});
+}
+
+template<class TokenType, class... Args>
+std::shared_ptr<TokenType> AmoebotParticle::makeToken(Args&&... args) {
+  return TokenStore::make<TokenType>(std::forward<Args>(args)...);
 }
 
 #endif  // AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
@@ -4,26 +4,76 @@
 
 #include "core/amoebotsystem.h"
 
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #include <QDateTime>
 #include <QtGlobal>
 
 #include "core/amoebotparticle.h"
 
+namespace {
+
+// Whether finishConstruction enables skipping quiescent particles.
+std::atomic<bool> quiescentSkippedByDefault(false);
+
+}  // namespace
+
+
+AmoebotSystem::AmoebotSystem(OccupancyIndex::Backend backend)
+  : occupancy(backend),
+    connectivity(occupancy),
+    _epoch(1),
+    _numUnactivated(0),
+    _roundCount(addCount("# Rounds")),
+    _activationCount(addCount("# Activations")),
+    _moveCount(addCount("# Moves")),
+    _adjacencyCached(false),
+    _quiescentSkipped(false),
+    _numUnactivatedQuiescent(0),
+    _rng(RandomStream::takeNextSeed()),
+    _previousBinding(RandomStream::bound()),
+    _scheduler(Scheduler::takeNextPolicy()),
+    _nextParticleId(0),
+    _activeParticle(nullptr),
+    _lastCheckedRound(0) {
+  RandomStream::bind(&_rng);
+}
 
-AmoebotSystem::AmoebotSystem() {
-  _counts.push_back(new Count("# Rounds"));
-  _counts.push_back(new Count("# Activations"));
-  _counts.push_back(new Count("# Moves"));
+void AmoebotSystem::finishConstruction() {
+  if (RandomStream::bound() == &_rng) {
+    RandomStream::bind(_previousBinding);
+  }
+  if (quiescentSkippedByDefault) {
+    setQuiescentSkipped(true);
+  }
 }
 
 AmoebotSystem::~AmoebotSystem() {
+  if (RandomStream::bound() == &_rng) {
+    RandomStream::bind(nullptr);
+  }
+
+  // Emplaced particles and objects are destructed in place; their storage is
+  // freed all at once when _arena is destructed.
   for (auto p : particles) {
-    delete p;
+    if (p->_arenaBytes == 0) {
+      delete p;
+    } else {
+      p->~AmoebotParticle();
+    }
   }
   particles.clear();
+  _positions.clear();
 
   for (auto t : immoparticles) {
-    delete t;
+    if (!_arena.owns(t)) {
+      delete t;
+    } else {
+      t->~ImmoParticle();
+    }
   }
   immoparticles.clear();
 
@@ -37,18 +87,87 @@ AmoebotSystem::~AmoebotSystem() {
 }
 
 void AmoebotSystem::activate() {
+  RandomStream::Scope scope(_rng);
   if (particles.size() > 0) {
-    AmoebotParticle* particle = particles.at(randInt(0, particles.size()));
-    registerActivation(particle);
-    particle->activate();
+    _rng.beginContext(RandomStream::schedulerStream, _activationCount._value);
+    if (_scheduler.usesPasses()) {
+      activateNextInPass();
+    } else if (!_quiescentSkipped) {
+      _scheduler.advanceTime(particles.size());
+      activateParticle(particles[_scheduler.next(particles.size())]);
+    } else if (_enabled.empty()) {
+      _scheduler.advanceTime(particles.size());
+      skipQuiescentActivations(1);
+    } else {
+      // Every activation picks a particle uniformly at random, so the number of
+      // activations of quiescent particles before the next activation of an
+      // enabled particle is geometrically distributed. In continuous time, the
+      // next enabled activation happens when the first of the enabled
+      // particles' clocks rings.
+      const unsigned long long numSkipped = randNumFailures(
+          static_cast<double>(_enabled.size()) / particles.size());
+      const unsigned long long numAllowed = numActivationsAllowed();
+      if (numSkipped >= numAllowed) {
+        // The activation limit is reached before the next enabled activation.
+        // Since the skipped activations are independent, stopping after the
+        // allowed ones leaves the distribution of later activations unchanged.
+        skipQuiescentActivations(numAllowed);
+        return;
+      }
+      skipQuiescentActivations(numSkipped);
+      _scheduler.advanceTime(_enabled.size());
+      activateParticle(_enabled[randInt(0, _enabled.size())]);
+    }
+  }
+}
+
+void AmoebotSystem::activateNextInPass() {
+  AmoebotParticle* particle = particles[_scheduler.next(particles.size())];
+  if (_quiescentSkipped) {
+    unsigned long long numAllowed = numActivationsAllowed();
+    while (particle->_quiescent && !_enabled.empty()) {
+      registerActivation(particle);
+      if (--numAllowed == 0) {
+        return;
+      }
+      particle = particles[_scheduler.next(particles.size())];
+    }
+    if (particle->_quiescent) {
+      registerActivation(particle);
+      return;
+    }
+  }
+  activateParticle(particle);
+}
+
+unsigned long long AmoebotSystem::numActivationsAllowed() const {
+  if (_activationLimit == 0) {
+    return std::numeric_limits<unsigned long long>::max();
+  } else if (_activationCount._value + 1 >= _activationLimit) {
+    return 1;
   }
+  return _activationLimit - _activationCount._value;
 }
 
 void AmoebotSystem::activateParticleAt(Node node) {
-  auto it = particleMap.find(node);
-  if (it != particleMap.end()) {
-    registerActivation(it->second);
-    it->second->activate();
+  RandomStream::Scope scope(_rng);
+  AmoebotParticle* particle = occupancy.particleAt(node);
+  if (particle != nullptr) {
+    activateParticle(particle);
+  }
+}
+
+void AmoebotSystem::activateParticle(AmoebotParticle* particle) {
+  registerActivation(particle);
+  _rng.beginContext(particle->_id, particle->_numActivations++);
+  _activeParticle = particle;
+  particle->activate();
+
+  // The particle may have removed itself from the system while activating.
+  if (_activeParticle != nullptr) {
+    refreshTrackedState(_activeParticle);
+    refreshQuiescence(_activeParticle);
+    _activeParticle = nullptr;
   }
 }
 
@@ -68,16 +187,39 @@ const std::deque<ImmoParticle*>& AmoebotSystem::getImmoParticles() const {
   return immoparticles;
 }
 
+const ParticlePositions& AmoebotSystem::positions() const {
+  return _positions;
+}
+
 void AmoebotSystem::insert(AmoebotParticle* particle) {
-  Q_ASSERT(particleMap.find(particle->head) == particleMap.end());
-  Q_ASSERT(immoparticleMap.find(particle->head) == immoparticleMap.end());
+  Q_ASSERT(occupancy.particleAt(particle->head) == nullptr);
+  Q_ASSERT(occupancy.objectAt(particle->head) == nullptr);
   Q_ASSERT(!particle->isExpanded() ||
-           particleMap.find(particle->tail()) == particleMap.end());
+           occupancy.particleAt(particle->tail()) == nullptr);
 
+  particle->_index = particles.size();
+  particle->_activationEpoch = 0;  // Not yet activated in the current round.
+  particle->_id = _nextParticleId++;
+  particle->_trackedState = -1;
+  refreshTrackedState(particle);
   particles.push_back(particle);
-  particleMap[particle->head] = particle;
+  _positions.append(particle->head, particle->globalTailDir,
+                    particle->orientation);
+  ++_numUnactivated;
+  occupancy.setParticle(particle->head, particle);
+  connectivity.nodeOccupied(particle->head);
   if (particle->isExpanded()) {
-    particleMap[particle->tail()] = particle;
+    occupancy.setParticle(particle->tail(), particle);
+    connectivity.nodeOccupied(particle->tail());
+  }
+  if (_adjacencyCached) {
+    linkNode(particle, particle->head);
+    if (particle->isExpanded()) {
+      linkNode(particle, particle->tail());
+    }
+  }
+  if (_quiescentSkipped) {
+    schedule(particle);
   }
 }
 
@@ -98,39 +240,207 @@ void AmoebotSystem::insert(AmoebotParticle* particle) {
 }*/
 
 void AmoebotSystem::insert(ImmoParticle* ImmoParticle) {
-  Q_ASSERT(immoparticleMap.find(ImmoParticle->_node) == immoparticleMap.end());
-  Q_ASSERT(particleMap.find(ImmoParticle->_node) == particleMap.end());
+  Q_ASSERT(occupancy.objectAt(ImmoParticle->_node) == nullptr);
+  Q_ASSERT(occupancy.particleAt(ImmoParticle->_node) == nullptr);
 
   immoparticles.push_back(ImmoParticle);
-  immoparticleMap[ImmoParticle->_node] = ImmoParticle;
+  occupancy.setObject(ImmoParticle->_node, ImmoParticle);
+}
+
+void AmoebotSystem::insert(const std::vector<AmoebotParticle*>& newParticles) {
+  particles.reserve(particles.size() + newParticles.size());
+  for (auto p : newParticles) {
+    insert(p);
+  }
+}
+
+void AmoebotSystem::insertEmplaced(AmoebotParticle* particle,
+                                   std::size_t bytes) {
+  particle->_arenaBytes = bytes;
+  insert(particle);
+}
+
+void AmoebotSystem::insertEmplaced(ImmoParticle* object, std::size_t) {
+  insert(object);
 }
 
 void AmoebotSystem::remove(AmoebotParticle* particle) {
-  particles.erase(std::remove(particles.begin(), particles.end(), particle),
-                  particles.end());
-  auto it = particleMap.begin();
-  while (it != particleMap.end()) {
-    if (it->second == particle) {
-      it = particleMap.erase(it);
-    } else {
-      it++;
+  Q_ASSERT(particle->_index < particles.size() &&
+           particles[particle->_index] == particle);
+
+  // Swap-and-pop: move the last particle into the vacated slot.
+  _scheduler.particleRemoved(particle->_index, particles.size() - 1);
+  AmoebotParticle* last = particles.back();
+  particles[particle->_index] = last;
+  last->_index = particle->_index;
+  particles.pop_back();
+  _positions.moveLastTo(particle->_index);
+
+  occupancy.eraseParticle(particle->head);
+  connectivity.nodeFreed(particle->head);
+  if (particle->isExpanded()) {
+    occupancy.eraseParticle(particle->tail());
+    connectivity.nodeFreed(particle->tail());
+  }
+  if (_adjacencyCached) {
+    unlinkNode(particle->head);
+    if (particle->isExpanded()) {
+      unlinkNode(particle->tail());
+    }
+  }
+  if (particle->_activationEpoch != _epoch) {
+    --_numUnactivated;
+  }
+  if (particle->_trackedState >= 0) {
+    --_statePopulations[particle->_trackedState];
+  }
+  if (particle == _activeParticle) {
+    _activeParticle = nullptr;
+  }
+  if (_quiescentSkipped) {
+    unschedule(particle);
+  }
+
+  destroy(particle);
+}
+
+void AmoebotSystem::remove(const std::vector<AmoebotParticle*>& oldParticles) {
+  for (auto p : oldParticles) {
+    remove(p);
+  }
+}
+
+void AmoebotSystem::destroy(AmoebotParticle* particle) {
+  if (particle->_arenaBytes == 0) {
+    delete particle;
+    return;
+  }
+
+  // The particle's block starts at its most derived object, which need not be
+  // its AmoebotParticle subobject.
+  void* block = dynamic_cast<void*>(particle);
+  const std::size_t bytes = particle->_arenaBytes;
+  particle->~AmoebotParticle();
+  _arena.release(block, bytes);
+}
+
+void AmoebotSystem::linkNode(AmoebotParticle* particle, const Node& node) {
+  AmoebotParticle** nbrs = particle->_nbrs[(node == particle->head) ? 0 : 1];
+  for (int dir = 0; dir < 6; ++dir) {
+    const Node nbrNode = node.nodeInDir(dir);
+    AmoebotParticle* nbr = occupancy.particleAt(nbrNode);
+    nbrs[dir] = nbr;
+    if (nbr != nullptr) {
+      nbr->_nbrs[(nbrNode == nbr->head) ? 0 : 1][(dir + 3) % 6] = particle;
     }
   }
-  activatedParticles.erase(particle);
+}
+
+void AmoebotSystem::schedule(AmoebotParticle* particle) {
+  particle->_quiescent = particle->isQuiescent();
+  if (!particle->_quiescent) {
+    particle->_scheduleIndex = _enabled.size();
+    _enabled.push_back(particle);
+  } else {
+    particle->_scheduleIndex = _quiescent.size();
+    _quiescent.push_back(particle);
+    if (particle->_activationEpoch != _epoch) {
+      swapQuiescent(particle->_scheduleIndex, _numUnactivatedQuiescent++);
+    }
+  }
+}
+
+void AmoebotSystem::unschedule(AmoebotParticle* particle) {
+  unsigned int i = particle->_scheduleIndex;
+  if (!particle->_quiescent) {
+    _enabled[i] = _enabled.back();
+    _enabled[i]->_scheduleIndex = i;
+    _enabled.pop_back();
+  } else {
+    // First move the particle to the back of the front part, if it is there.
+    if (i < _numUnactivatedQuiescent) {
+      swapQuiescent(i, --_numUnactivatedQuiescent);
+      i = _numUnactivatedQuiescent;
+    }
+    swapQuiescent(i, _quiescent.size() - 1);
+    _quiescent.pop_back();
+  }
+}
 
-  delete particle;
+void AmoebotSystem::swapQuiescent(unsigned int i, unsigned int j) {
+  std::swap(_quiescent[i], _quiescent[j]);
+  _quiescent[i]->_scheduleIndex = i;
+  _quiescent[j]->_scheduleIndex = j;
+}
+
+void AmoebotSystem::skipQuiescentActivations(
+    unsigned long long numActivations) {
+  while (numActivations > 0) {
+    if (_numUnactivatedQuiescent == 0) {
+      _activationCount.record(numActivations);
+      return;
+    }
+
+    // Activations that reach quiescent particles already activated in this
+    // round only need to be counted.
+    const unsigned long long numRepeated = randNumFailures(
+        static_cast<double>(_numUnactivatedQuiescent) / _quiescent.size());
+    if (numRepeated >= numActivations) {
+      _activationCount.record(numActivations);
+      return;
+    }
+    _activationCount.record(numRepeated);
+    numActivations -= numRepeated + 1;
+    registerActivation(_quiescent[randInt(0, _numUnactivatedQuiescent)]);
+  }
+}
+
+unsigned long long AmoebotSystem::randNumFailures(double successProb) {
+  if (successProb >= 1.0) {
+    return 0;
+  }
+
+  // Inverse transform sampling: at least k trials fail with probability
+  // (1 - successProb)^k. The first trial succeeds iff u < successProb, which
+  // saves computing the logarithms in the common case.
+  const double u = randDouble(0.0, 1.0);
+  if (u < successProb) {
+    return 0;
+  }
+  const double numFailures =
+      std::floor(std::log1p(-u) / std::log1p(-successProb));
+  return (numFailures < 1e18) ? static_cast<unsigned long long>(numFailures)
+                              : 1000000000000000000ull;
+}
+
+void AmoebotSystem::unlinkNode(const Node& node) {
+  for (int dir = 0; dir < 6; ++dir) {
+    const Node nbrNode = node.nodeInDir(dir);
+    AmoebotParticle* nbr = occupancy.particleAt(nbrNode);
+    if (nbr != nullptr) {
+      nbr->_nbrs[(nbrNode == nbr->head) ? 0 : 1][(dir + 3) % 6] = nullptr;
+    }
+  }
 }
 
 void AmoebotSystem::registerMovement(unsigned int numMoves) {
-  getCount("# Moves").record(numMoves);
+  _moveCount.record(numMoves);
 }
 
 void AmoebotSystem::registerActivation(AmoebotParticle* particle) {
-  getCount("# Activations").record();
-  activatedParticles.insert(particle);
-  if (activatedParticles.size() == particles.size()) {
+  _activationCount.record();
+  if (particle->_activationEpoch != _epoch) {
+    particle->_activationEpoch = _epoch;
+    --_numUnactivated;
+    if (_quiescentSkipped && particle->_quiescent) {
+      swapQuiescent(particle->_scheduleIndex, --_numUnactivatedQuiescent);
+    }
+  }
+  if (_numUnactivated == 0) {
     registerRound();
-    activatedParticles.clear();
+    ++_epoch;
+    _numUnactivated = particles.size();
+    _numUnactivatedQuiescent = _quiescent.size();
   }
 }
 
@@ -139,11 +449,125 @@ void AmoebotSystem::registerRound() {
     c->_history.push_back(c->_value);
   }
   for (const auto& m : _measures) {
-    if (getCount("# Rounds")._value % m->_freq == 0) {
+    if (_roundCount._value % m->_freq == 0) {
       m->_history.push_back(m->calculate());
     }
   }
-  getCount("# Rounds").record();
+  _roundCount.record();
+}
+
+unsigned int AmoebotSystem::numInTrackedState(int state) const {
+  return (0 <= state && state < static_cast<int>(_statePopulations.size()))
+      ? _statePopulations[state] : 0;
+}
+
+void AmoebotSystem::refreshTrackedState(AmoebotParticle* particle) {
+  const int state = particle->trackedState();
+  if (state == particle->_trackedState) {
+    return;
+  }
+  if (particle->_trackedState >= 0) {
+    --_statePopulations[particle->_trackedState];
+  }
+  if (state >= 0) {
+    if (state >= static_cast<int>(_statePopulations.size())) {
+      _statePopulations.resize(state + 1, 0);
+    }
+    ++_statePopulations[state];
+  }
+  particle->_trackedState = state;
+}
+
+bool AmoebotSystem::isTerminationCheckDue() {
+  if (_terminationCheckInterval == 0) {
+    if (_roundCount._value != _lastCheckedRound) {
+      _lastCheckedRound = _roundCount._value;
+      return true;
+    }
+    return false;
+  }
+  return System::isTerminationCheckDue();
+}
+
+bool AmoebotSystem::isConnected() const {
+  return connectivity.isConnected();
+}
+
+void AmoebotSystem::setConnectivityMonitored(bool monitored) {
+  connectivity.setEnabled(monitored);
+}
+
+void AmoebotSystem::setAdjacencyCached(bool cached) {
+  if (cached && !_adjacencyCached) {
+    for (auto p : particles) {
+      linkNode(p, p->head);
+      if (p->isExpanded()) {
+        linkNode(p, p->tail());
+      }
+    }
+  }
+  _adjacencyCached = cached;
+}
+
+bool AmoebotSystem::isAdjacencyCached() const {
+  return _adjacencyCached;
+}
+
+void AmoebotSystem::setQuiescentSkipped(bool skipped) {
+  _enabled.clear();
+  _quiescent.clear();
+  _numUnactivatedQuiescent = 0;
+  _quiescentSkipped = skipped;
+  if (skipped) {
+    for (auto p : particles) {
+      schedule(p);
+    }
+  }
+}
+
+bool AmoebotSystem::isQuiescentSkipped() const {
+  return _quiescentSkipped;
+}
+
+void AmoebotSystem::setQuiescentSkippedByDefault(bool skipped) {
+  quiescentSkippedByDefault = skipped;
+}
+
+bool AmoebotSystem::isQuiescentSkippedByDefault() {
+  return quiescentSkippedByDefault;
+}
+
+unsigned int AmoebotSystem::numQuiescent() const {
+  return _quiescent.size();
+}
+
+void AmoebotSystem::refreshQuiescence(AmoebotParticle* particle) {
+  if (_quiescentSkipped && particle->isQuiescent() != particle->_quiescent) {
+    unschedule(particle);
+    schedule(particle);
+  }
+}
+
+void AmoebotSystem::setSchedulerPolicy(Scheduler::Policy policy) {
+  _scheduler.setPolicy(policy);
+}
+
+Scheduler::Policy AmoebotSystem::schedulerPolicy() const {
+  return _scheduler.policy();
+}
+
+double AmoebotSystem::schedulerTime() const {
+  return _scheduler.time();
+}
+
+Count& AmoebotSystem::addCount(const QString name) {
+  _counts.push_back(new Count(name));
+  return *_counts.back();
+}
+
+Measure& AmoebotSystem::addMeasure(Measure* measure) {
+  _measures.push_back(measure);
+  return *measure;
 }
 
 const std::vector<Count*>& AmoebotSystem::getCounts() const {
@@ -173,11 +597,69 @@ Measure& AmoebotSystem::getMeasure(QString name) const {
 }
 
 
+uint64_t AmoebotSystem::getRandomSeed() const {
+  return _rng.getSeed();
+}
+
+void AmoebotSystem::setRandomSeed(uint64_t seed) {
+  _rng.seed(seed);
+}
+
+std::size_t AmoebotSystem::MemoryUsage::totalBytes() const {
+  return particleBytes + arenaBytes + tokenBytes + occupancyBytes;
+}
+
+AmoebotSystem::MemoryUsage AmoebotSystem::memoryUsage() const {
+  MemoryUsage usage;
+  usage.numParticles = particles.size();
+  usage.numParticlesWithTokens = 0;
+  usage.particleBytes = particles.capacity() * sizeof(AmoebotParticle*);
+  usage.particleBytes += _positions.memoryUsage();
+  usage.particleBytes += (_enabled.capacity() + _quiescent.capacity()) *
+                         sizeof(AmoebotParticle*);
+  usage.particleBytes += _scheduler.memoryUsage();
+  usage.arenaBytes = _arena.memoryUsage();
+  usage.tokenBytes = 0;
+  for (auto p : particles) {
+    if (p->_arenaBytes == 0) {
+      usage.particleBytes += sizeof(AmoebotParticle);
+    }
+    const std::size_t bytes = p->tokens.memoryUsage();
+    if (bytes > 0) {
+      ++usage.numParticlesWithTokens;
+      usage.tokenBytes += bytes;
+    }
+  }
+  usage.occupancyBytes = occupancy.memoryUsage();
+  return usage;
+}
+
+const QString AmoebotSystem::memoryAsJSON() const {
+  const MemoryUsage usage = memoryUsage();
+  QString json = "{\"particles\" : " + QString::number(usage.numParticles);
+  json += ", \"particlesWithTokens\" : " +
+          QString::number(usage.numParticlesWithTokens);
+  json += ", \"particleBytes\" : " + QString::number(usage.particleBytes);
+  json += ", \"arenaBytes\" : " + QString::number(usage.arenaBytes);
+  json += ", \"tokenBytes\" : " + QString::number(usage.tokenBytes);
+  json += ", \"occupancyBytes\" : " + QString::number(usage.occupancyBytes);
+  json += ", \"totalBytes\" : " + QString::number(usage.totalBytes()) + "}";
+  return json;
+}
+
 const QString AmoebotSystem::metricsAsJSON() const {
   QString json = "{\"title\" : \"AmoebotSim Metrics JSON\", ";
   json += "\"datetime\" : \"" +
           QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
   json += "\"algorithm\" : \"???\", ";
+  json += "\"seed\" : " + QString::number(_rng.getSeed()) + ", ";
+  json += "\"rng\" : \"" +
+          QString(RandomStream::engineName(_rng.getEngine())) + "\", ";
+  json += "\"scheduler\" : \"" +
+          Scheduler::policyName(_scheduler.policy()) + "\", ";
+  if (_scheduler.policy() == Scheduler::Policy::Poisson) {
+    json += "\"time\" : " + QString::number(_scheduler.time()) + ", ";
+  }
   json += "\"counts\" : [";
   for (const auto& c : _counts) {
     json += "{\"name\" : \"" + c->_name + "\", ";
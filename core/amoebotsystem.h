@@ -8,15 +8,21 @@
 #ifndef AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
 #define AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
 
+#include <cstddef>
 #include <deque>
-#include <map>
-#include <set>
+#include <new>
+#include <utility>
 #include <vector>
 
 #include <QString>
 
+#include "core/connectivitymonitor.h"
 #include "core/metric.h"
 #include "core/immoparticle.h"
+#include "core/occupancyindex.h"
+#include "core/particlearena.h"
+#include "core/particlepositions.h"
+#include "core/scheduler.h"
 #include "core/system.h"
 #include "helper/randomnumbergenerator.h"
 
@@ -28,16 +34,41 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
 
  public:
   // Constructs a new particle system with fresh round, activation, and movement
-  // counts.
-  AmoebotSystem();
+  // counts. The backend determines how the system indexes occupied nodes; the
+  // ordered backend is the original std::map implementation and is kept as a
+  // reference for validating the faster hashed and tiled ones. The system's
+  // random stream is seeded with RandomStream::takeNextSeed() and bound to the
+  // calling thread until finishConstruction is called, so that the subclass
+  // constructor (and the constructors of the particles it creates) draw from
+  // it. The system's scheduler uses the policy returned by
+  // Scheduler::takeNextPolicy().
+  explicit AmoebotSystem(OccupancyIndex::Backend backend =
+                             OccupancyIndex::Backend::Tiled);
+
+  // Restores the random stream binding of the calling thread that the
+  // constructor replaced, and enables skipping quiescent particles if
+  // isQuiescentSkippedByDefault(). Must be called on the constructing thread
+  // once the subclass constructor has returned; otherwise that thread keeps
+  // drawing from the system's stream, racing with the thread that activates it.
+  void finishConstruction();
 
   // Deletes the particles, objects, and metrics in this system before
-  // destructing the system.
+  // destructing the system. Particles and objects constructed by emplace are
+  // only destructed; their storage is freed in bulk with the system's arena.
+  // Unbinds the system's random stream if it is still bound to the calling
+  // thread.
   virtual ~AmoebotSystem();
 
-  // Functions for activating a particle in the system. activate activates a
-  // random particle in the system, while activateParticleAt activates the
-  // particle occupying the specified node if such a particle exists.
+  // Functions for activating a particle in the system. activate activates the
+  // particle chosen by the system's scheduler (see setSchedulerPolicy), while
+  // activateParticleAt activates the particle occupying the specified node if
+  // such a particle exists. Both bind the system's random stream for the
+  // duration of the activation and open a random context for the activated
+  // particle (see randomnumbergenerator.h).
+  // While quiescent particles are skipped (see setQuiescentSkipped), activate
+  // also accounts for the activations of quiescent particles that precede the
+  // next activation of a particle that is not quiescent, stopping early at the
+  // activation limit (see System::setActivationLimit).
   void activate() final;
   void activateParticleAt(Node node) final;
 
@@ -53,30 +84,121 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
   // Returns a reference to the immobilized particle list.
   virtual const std::deque<ImmoParticle*>& getImmoParticles() const final;
 
-  // Inserts a particle or an object, respectively, into the system. A particle
-  // can be contracted or expanded. Fails if the respective node(s) are already
-  // occupied.
-  void insert(AmoebotParticle* particle);
-  void insert(ImmoParticle* ImmoParticle);
+  // Returns the positions of the particles as contiguous arrays, in the order
+  // of particles; see particlepositions.h.
+  const ParticlePositions& positions() const final;
 
-  // Removes the specified particle from the system.
+  // Constructs a particle or an object of type T from the given arguments in
+  // this system's arena and inserts it (see insert below), e.g.,
+  // emplace<FooParticle>(node, -1, randDir(), *this). T must derive from
+  // AmoebotParticle or be an ImmoParticle. Consecutively emplaced particles are
+  // stored contiguously; see particlearena.h. Returns the new particle/object.
+  // Typed systems hide this with AmoebotSystemT::emplace, which only accepts
+  // their particle type.
+  template<class T, class... Args>
+  T& emplace(Args&&... args);
+
+  // Removes the specified particle(s) from the system and deletes them. Each
+  // removal takes constant time: the last particle is moved into the removed
+  // particle's slot and only the removed particle's head and tail nodes are
+  // cleared from the occupancy index. Note that this changes the order in which
+  // particles are iterated over.
   void remove(AmoebotParticle* particle);
+  void remove(const std::vector<AmoebotParticle*>& oldParticles);
 
   // Functions for logging system progress. registerMovement logs the given
   // number of movements the system has made. registerActivation logs that the
   // given particle has been activated. When all particles have been activated
   // at least once, this resets its logging and triggers registerRound(), which
   // commits all counts and measures to their histories and increments the
-  // number of completed asynchronous rounds by one.
+  // number of completed asynchronous rounds by one. Round tracking is O(1) per
+  // activation: each particle is stamped with the epoch of the round in which
+  // it was last activated, and the system counts how many particles have not
+  // been stamped with the current epoch yet.
   void registerMovement(unsigned int numMoves = 1);
   void registerActivation(AmoebotParticle* particle);
   void registerRound();
 
+  // State populations. numInTrackedState returns the number of particles whose
+  // trackedState() (see amoebotparticle.h) currently equals the given state.
+  // The populations are updated when particles are inserted or removed and
+  // after every activation for the activated particle, so algorithms whose
+  // particles only change their own tracked state need no further bookkeeping.
+  // An algorithm that changes the tracked state of another particle must call
+  // refreshTrackedState for that particle.
+  unsigned int numInTrackedState(int state) const;
+  void refreshTrackedState(AmoebotParticle* particle);
+
+  // Returns true if a termination check is due after the last activation; see
+  // System::setTerminationCheckInterval. With interval 0, a check is due once
+  // after each completed round.
+  bool isTerminationCheckDue() override;
+
+  // Returns true if and only if the particles form one connected component.
+  // While connectivity is monitored (the default in debug builds), this is
+  // kept up to date incrementally as particles move, so it can be checked after
+  // every activation; otherwise, every call runs a full search. See
+  // connectivitymonitor.h.
+  bool isConnected() const;
+  void setConnectivityMonitored(bool monitored);
+
+  // Enables or disables the adjacency cache (disabled by default). While it is
+  // enabled, every particle keeps pointers to the particles on its neighboring
+  // nodes, so AmoebotParticle::nbrAtLabel and hasNbrAtLabel read a pointer
+  // instead of looking up the occupancy index. In exchange, every movement,
+  // insertion, and removal updates the pointers of the particles around the
+  // nodes it occupies or frees. Enabling the cache builds it in O(n).
+  void setAdjacencyCached(bool cached);
+  bool isAdjacencyCached() const;
+
+  // Enables or disables skipping quiescent particles (disabled by default; see
+  // AmoebotParticle::isQuiescent). While enabled, the system keeps the set of
+  // particles that are not quiescent (the enabled particles) and activate only
+  // runs enabled particles. Activating a quiescent particle does nothing, so
+  // instead of running those activations, the system samples how many of them
+  // precede the next enabled activation and which quiescent particles they
+  // reach for the first time in the current round. The activation and round
+  // counts thus follow the same distribution as without skipping, while the
+  // cost of an activate call no longer grows with the number of quiescent
+  // particles. numQuiescent returns the number of quiescent particles (0 while
+  // skipping is disabled). Quiescence is re-evaluated when particles are
+  // inserted and after every activation for the activated particle, so an
+  // algorithm that changes whether another particle is quiescent must call
+  // refreshQuiescence for that particle.
+  void setQuiescentSkipped(bool skipped);
+  bool isQuiescentSkipped() const;
+
+  // Sets or returns whether finishConstruction enables skipping quiescent
+  // particles in subsequently constructed systems (disabled by default).
+  // Skipping changes how a seeded run unfolds, so it is opt-in per run.
+  static void setQuiescentSkippedByDefault(bool skipped);
+  static bool isQuiescentSkippedByDefault();
+  unsigned int numQuiescent() const;
+  void refreshQuiescence(AmoebotParticle* particle);
+
+  // Returns or changes the policy activate uses to choose the next particle;
+  // see scheduler.h. Under the Permutation and Sweep policies, a skipped
+  // quiescent particle (see setQuiescentSkipped) still uses up its turn in the
+  // current pass. schedulerTime returns the continuous time that has passed
+  // under the Poisson policy.
+  void setSchedulerPolicy(Scheduler::Policy policy);
+  Scheduler::Policy schedulerPolicy() const;
+  double schedulerTime() const;
+
+  // Functions for registering metrics. addCount creates a new count with the
+  // given name, while addMeasure takes ownership of the given measure. Both
+  // return a handle (reference) to the registered metric that stays valid for
+  // the lifetime of the system; code that records metrics on every activation
+  // should keep this handle instead of looking the metric up by name.
+  Count& addCount(const QString name);
+  Measure& addMeasure(Measure* measure);
+
   // Various access functions for metrics (counts and measures). getCounts
   // (resp., getMeasures) returns a reference to the count (resp., measure)
   // list. getCount (resp., getMeasure) returns a reference to the named count
   // (resp., measure). These functions crash if the requested count/measure is
-  // not found!
+  // not found! The by-name lookups do a linear scan and are meant for scripts
+  // and the GUI, not for hot paths.
   const std::vector<Count*>& getCounts() const final;
   const std::vector<Measure*>& getMeasures() const final;
   Count& getCount(QString name) const final;
@@ -86,6 +208,28 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
   // this JSON string can be found in the Usage documentation.
   const QString metricsAsJSON() const final;
 
+  // The memory held by this system, in bytes. particleBytes counts the particle
+  // list, its position arrays, the lists of enabled and quiescent particles
+  // (see setQuiescentSkipped), the scheduler's current pass, and the
+  // AmoebotParticle part of each particle that was not emplaced (algorithm
+  // subclasses add their own members), arenaBytes counts the arena holding the
+  // emplaced particles and objects in full, tokenBytes counts the token stores
+  // of the particles that have held tokens (see tokenstore.h), and
+  // occupancyBytes counts the occupancy index.
+  // memoryUsage computes these in O(n); memoryAsJSON formats them.
+  struct MemoryUsage {
+    unsigned int numParticles;
+    unsigned int numParticlesWithTokens;
+    std::size_t particleBytes;
+    std::size_t arenaBytes;
+    std::size_t tokenBytes;
+    std::size_t occupancyBytes;
+
+    std::size_t totalBytes() const;
+  };
+  MemoryUsage memoryUsage() const;
+  const QString memoryAsJSON() const final;
+
 
   // Currently used in the function updateBorderColors
   // in the class ShapeFormationFaultTolerantParticle
@@ -94,16 +238,107 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
   // in the fault-tolerant hexagon shape formation algorithm.
   int seedOrientation() const;
 
+  // Returns the seed of this system's random stream, or restarts the stream
+  // from the given seed. Two systems constructed with the same seed and
+  // parameters and activated the same number of times are identical.
+  uint64_t getRandomSeed() const;
+  void setRandomSeed(uint64_t seed);
+
 
  protected:
+  // Inserts a particle or an object, respectively, into the system. A particle
+  // can be contracted or expanded. Fails if the respective node(s) are already
+  // occupied. The bulk version inserts the given particles in order. These
+  // accept any particle type, so they are only available to subclasses; typed
+  // systems expose AmoebotSystemT::insert instead, which only accepts their
+  // particle type.
+  void insert(AmoebotParticle* particle);
+  void insert(ImmoParticle* ImmoParticle);
+  void insert(const std::vector<AmoebotParticle*>& newParticles);
+
   std::vector<AmoebotParticle*> particles;
-  std::map<Node, AmoebotParticle*> particleMap;
-  std::set<AmoebotParticle*> activatedParticles;
+  OccupancyIndex occupancy;
+  ConnectivityMonitor connectivity;
+  unsigned int _epoch;
+  unsigned int _numUnactivated;
   std::deque<ImmoParticle*> immoparticles;
-  std::map<Node, ImmoParticle*> immoparticleMap;
   std::vector<Count*> _counts;
   std::vector<Measure*> _measures;
+  Count& _roundCount;
+  Count& _activationCount;
+  Count& _moveCount;
   int _seedOrientation;
+
+ private:
+  // Activates the given particle, keeping its random context, round tracking,
+  // and tracked state up to date.
+  void activateParticle(AmoebotParticle* particle);
+
+  // Activates the next particle of the scheduler's current pass. While
+  // quiescent particles are skipped, the turns of quiescent particles up to the
+  // next enabled particle are only registered as activations.
+  void activateNextInPass();
+
+  // Returns the number of activations the current activate call may record
+  // under the activation limit (see System::setActivationLimit); at least 1.
+  unsigned long long numActivationsAllowed() const;
+
+  // Inserts a particle or an object that emplace constructed in a block of the
+  // given number of bytes of the arena.
+  void insertEmplaced(AmoebotParticle* particle, std::size_t bytes);
+  void insertEmplaced(ImmoParticle* object, std::size_t bytes);
+
+  // Destructs the given (already removed) particle and frees its storage,
+  // returning it to the arena if it was emplaced.
+  void destroy(AmoebotParticle* particle);
+
+  // Functions for maintaining the adjacency cache. linkNode fills the given
+  // particle's neighbor pointers for the given node, which it occupies, and
+  // points the particles around that node back at it. unlinkNode clears the
+  // pointers of the particles around the given node, which was just freed.
+  void linkNode(AmoebotParticle* particle, const Node& node);
+  void unlinkNode(const Node& node);
+
+  // Functions for maintaining the lists of enabled and quiescent particles.
+  // schedule adds the given particle to the list matching its isQuiescent(),
+  // and unschedule removes it from its list. The quiescent particles that have
+  // not been activated in the current round are kept at the front of their
+  // list; swapQuiescent swaps two entries of that list.
+  void schedule(AmoebotParticle* particle);
+  void unschedule(AmoebotParticle* particle);
+  void swapQuiescent(unsigned int i, unsigned int j);
+
+  // Accounts for the given number of activations of quiescent particles,
+  // stamping those that are activated for the first time in the current round.
+  void skipQuiescentActivations(unsigned long long numActivations);
+
+  // Returns the number of failed trials before the first success in a sequence
+  // of independent trials that succeed with the given probability.
+  static unsigned long long randNumFailures(double successProb);
+
+  ParticleArena _arena;
+  ParticlePositions _positions;
+  bool _adjacencyCached;
+  bool _quiescentSkipped;
+  std::vector<AmoebotParticle*> _enabled;
+  std::vector<AmoebotParticle*> _quiescent;
+  unsigned int _numUnactivatedQuiescent;
+  RandomStream _rng;
+  RandomStream* _previousBinding;
+  Scheduler _scheduler;
+  uint32_t _nextParticleId;
+  std::vector<unsigned int> _statePopulations;
+  AmoebotParticle* _activeParticle;
+  unsigned long long _lastCheckedRound;
 };
 
+template<class T, class... Args>
+T& AmoebotSystem::emplace(Args&&... args) {
+  void* block = _arena.allocate(sizeof(T));
+  T* object = new (block) T(std::forward<Args>(args)...);
+  insertEmplaced(object, sizeof(T));
+
+  return *object;
+}
+
 #endif  // AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
@@ -0,0 +1,149 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/connectivitymonitor.h"
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// Packs a node into a single key for the visited sets of the searches below.
+uint64_t nodeKey(const Node& node) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(node.x)) << 32)
+         | static_cast<uint32_t>(node.y);
+}
+
+}  // namespace
+
+ConnectivityMonitor::ConnectivityMonitor(const OccupancyIndex& occupancy)
+  : _occupancy(occupancy),
+#ifdef QT_DEBUG
+    _enabled(true),
+#else
+    _enabled(false),
+#endif
+    _status(Status::Unknown) {}
+
+void ConnectivityMonitor::setEnabled(bool enabled) {
+  _enabled = enabled;
+  _status = Status::Unknown;
+}
+
+bool ConnectivityMonitor::isEnabled() const {
+  return _enabled;
+}
+
+bool ConnectivityMonitor::isConnected() const {
+  if (!_enabled) {
+    return searchAll();
+  } else if (_status == Status::Unknown) {
+    _status = searchAll() ? Status::Connected : Status::Disconnected;
+  }
+  return _status == Status::Connected;
+}
+
+ConnectivityMonitor::Status ConnectivityMonitor::statusAfterFreeing(
+    const Node& node) const {
+  // Start one search from the first node of each run of occupied neighbors.
+  std::vector<Node> seeds;
+  for (int dir = 0; dir < 6; ++dir) {
+    if (isParticleNode(node.nodeInDir(dir)) &&
+        !isParticleNode(node.nodeInDir((dir + 5) % 6))) {
+      seeds.push_back(node.nodeInDir(dir));
+    }
+  }
+
+  const int numSearches = seeds.size();
+  std::vector<std::deque<Node>> frontiers(numSearches);
+  std::vector<int> group(numSearches);
+  std::unordered_map<uint64_t, int> owner;
+  for (int i = 0; i < numSearches; ++i) {
+    frontiers[i].push_back(seeds[i]);
+    group[i] = i;
+    owner.emplace(nodeKey(seeds[i]), i);
+  }
+
+  // Advance every search by one node per step. Searches that reach a node
+  // already visited by another search join its group; once a single group is
+  // left, all runs are still connected. A group whose searches have all run
+  // out of nodes is a component that no longer reaches the others. Past the
+  // node cap, the verdict is left to a full search.
+  int numGroups = numSearches;
+  while (true) {
+    for (int i = 0; i < numSearches; ++i) {
+      if (frontiers[i].empty()) {
+        continue;
+      }
+      const Node current = frontiers[i].front();
+      frontiers[i].pop_front();
+      for (int dir = 0; dir < 6; ++dir) {
+        const Node nbr = current.nodeInDir(dir);
+        if (!isParticleNode(nbr)) {
+          continue;
+        }
+        auto it = owner.find(nodeKey(nbr));
+        if (it == owner.end()) {
+          if (owner.size() >= maxLocalSearchNodes) {
+            return Status::Unknown;
+          }
+          owner.emplace(nodeKey(nbr), i);
+          frontiers[i].push_back(nbr);
+        } else if (group[it->second] != group[i]) {
+          const int merged = group[it->second];
+          for (int j = 0; j < numSearches; ++j) {
+            if (group[j] == merged) {
+              group[j] = group[i];
+            }
+          }
+          if (--numGroups == 1) {
+            return Status::Connected;
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < numSearches; ++i) {
+      bool isExhausted = true;
+      for (int j = 0; j < numSearches && isExhausted; ++j) {
+        isExhausted = group[j] != group[i] || frontiers[j].empty();
+      }
+      if (isExhausted) {
+        return Status::Disconnected;
+      }
+    }
+  }
+}
+
+bool ConnectivityMonitor::searchAll() const {
+  const unsigned int numNodes = _occupancy.numParticleNodes();
+  if (numNodes == 0) {
+    return true;
+  }
+
+  std::deque<Node> queue;
+  _occupancy.forEachParticleNode([&queue](const Node& node, AmoebotParticle*) {
+    if (queue.empty()) {
+      queue.push_back(node);
+    }
+  });
+
+  std::unordered_set<uint64_t> visited;
+  visited.insert(nodeKey(queue.front()));
+  while (!queue.empty()) {
+    const Node current = queue.front();
+    queue.pop_front();
+    for (int dir = 0; dir < 6; ++dir) {
+      const Node nbr = current.nodeInDir(dir);
+      if (isParticleNode(nbr) && visited.insert(nodeKey(nbr)).second) {
+        queue.push_back(nbr);
+      }
+    }
+  }
+
+  return visited.size() == numNodes;
+}
@@ -0,0 +1,122 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a monitor that keeps track of whether the nodes occupied by particles
+// form one connected component while particles move. It is told about every
+// node that becomes occupied or free and updates its verdict locally:
+//
+//  - Occupying a node next to an occupied node keeps a connected system
+//    connected.
+//  - Freeing a node keeps a connected system connected if its occupied
+//    neighbors form a single run around the node, since consecutive neighbors
+//    of a node are adjacent to each other.
+//  - Otherwise, one search is started from each run of occupied neighbors and
+//    the searches are advanced in lockstep until they have all met (still
+//    connected) or one of them runs out of nodes (disconnected). Its cost is
+//    thus bounded by the size of the smaller side of a split, or by the length
+//    of the shortest detour around the freed node, and in any case by
+//    maxLocalSearchNodes visited nodes.
+//
+// Verdicts that cannot be decided locally (e.g., occupying a node while the
+// system is already disconnected, or a local search hitting its node cap) are
+// deferred to a full search the next time the verdict is requested.
+
+#ifndef AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
+#define AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
+
+#include "core/node.h"
+#include "core/occupancyindex.h"
+
+class ConnectivityMonitor {
+ public:
+  // Constructs a monitor for the particle nodes of the given index. Monitoring
+  // starts out enabled in debug builds and disabled otherwise.
+  explicit ConnectivityMonitor(const OccupancyIndex& occupancy);
+
+  // Enables or disables incremental monitoring. While disabled, node updates
+  // are ignored and isConnected runs a full search on every call.
+  void setEnabled(bool enabled);
+  bool isEnabled() const;
+
+  // Functions for reporting changes to the index. nodeOccupied must be called
+  // right after a node becomes occupied by a particle, and nodeFreed right
+  // after a particle leaves a node; changes of the particle occupying a node
+  // (e.g., handovers) need not be reported. When a particle occupies or frees
+  // two nodes, each node must be reported right after its own update.
+  void nodeOccupied(const Node& node);
+  void nodeFreed(const Node& node);
+
+  // Returns true if and only if the nodes occupied by particles form one
+  // connected component. An empty system is connected.
+  bool isConnected() const;
+
+ private:
+  enum class Status {
+    Connected,
+    Disconnected,
+    Unknown
+  };
+
+  // Returns true if and only if the given node is occupied by a particle.
+  bool isParticleNode(const Node& node) const;
+
+  // The number of nodes a local search may visit before it gives up and defers
+  // the verdict to a full search.
+  static const unsigned int maxLocalSearchNodes = 4096;
+
+  // Decides whether freeing the given node disconnected the system by searching
+  // from one node of each run of its occupied neighbors; see above. Returns
+  // Unknown if the searches visit maxLocalSearchNodes nodes without a verdict.
+  Status statusAfterFreeing(const Node& node) const;
+
+  // Runs a breadth-first search over all particle nodes.
+  bool searchAll() const;
+
+  const OccupancyIndex& _occupancy;
+  bool _enabled;
+  mutable Status _status;
+};
+
+inline void ConnectivityMonitor::nodeOccupied(const Node& node) {
+  if (!_enabled || _status != Status::Connected) {
+    _status = Status::Unknown;
+    return;
+  }
+
+  for (int dir = 0; dir < 6; ++dir) {
+    if (isParticleNode(node.nodeInDir(dir))) {
+      return;  // Attached to the (connected) rest of the system.
+    }
+  }
+  if (_occupancy.numParticleNodes() > 1) {
+    _status = Status::Disconnected;
+  }
+}
+
+inline void ConnectivityMonitor::nodeFreed(const Node& node) {
+  if (!_enabled || _status != Status::Connected) {
+    _status = Status::Unknown;
+    return;
+  }
+
+  // Count the runs of occupied neighbors around the freed node.
+  int numRuns = 0;
+  bool prevOccupied = isParticleNode(node.nodeInDir(5));
+  for (int dir = 0; dir < 6; ++dir) {
+    const bool occupied = isParticleNode(node.nodeInDir(dir));
+    if (occupied && !prevOccupied) {
+      ++numRuns;
+    }
+    prevOccupied = occupied;
+  }
+  if (numRuns > 1) {
+    _status = statusAfterFreeing(node);
+  }
+}
+
+inline bool ConnectivityMonitor::isParticleNode(const Node& node) const {
+  return _occupancy.particleAt(node) != nullptr;
+}
+
+#endif  // AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
@@ -0,0 +1,41 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/densitymap.h"
+
+#include <QtGlobal>
+
+constexpr int DensityMap::cellShift;
+constexpr int DensityMap::tileShift;
+constexpr int DensityMap::cellsPerTileSide;
+
+DensityMap::Tile::Tile(const Node& origin)
+  : origin(origin) {
+  counts.fill(0);
+}
+
+void DensityMap::add(const Node& node) {
+  const Node cell = cellOf(node);
+  uint8_t& count = tileOf(cell).counts[cellIndexOf(cell)];
+  Q_ASSERT(count < (1 << (2 * cellShift)));
+  ++count;
+}
+
+void DensityMap::remove(const Node& node) {
+  const Node cell = cellOf(node);
+  uint8_t& count = tileOf(cell).counts[cellIndexOf(cell)];
+  Q_ASSERT(count > 0);
+  --count;
+}
+
+void DensityMap::clear() {
+  _index.clear();
+  _tiles.clear();
+}
+
+std::size_t DensityMap::memoryUsage() const {
+  return _index.memoryUsage() +
+         _tiles.capacity() * sizeof(std::unique_ptr<Tile>) +
+         _tiles.size() * sizeof(Tile);
+}
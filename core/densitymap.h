@@ -0,0 +1,105 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a density map, which counts the particle heads in every cell of 4x4
+// lattice nodes. Cells are stored in tiles of 4x4 cells (16x16 nodes, the tiles
+// of a render snapshot) that are allocated lazily and addressed by a hash of
+// their tile coordinates, like the tiles of TileGrid. ParticlePositions keeps
+// its density map up to date with every insertion, removal, and movement, so
+// the visualization can draw how dense each part of a large system is without
+// going through its particles.
+
+#ifndef AMOEBOTSIM_CORE_DENSITYMAP_H_
+#define AMOEBOTSIM_CORE_DENSITYMAP_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/node.h"
+#include "core/nodehashmap.h"
+
+class DensityMap {
+ public:
+  // Cells are 4x4 nodes, and tiles are 4x4 cells. The count of cell (cx, cy)
+  // is stored at index cellIndexOf(cx, cy) of its tile's counts.
+  static constexpr int cellShift = 2;
+  static constexpr int tileShift = 4;
+  static constexpr int cellsPerTileSide = 1 << (tileShift - cellShift);
+
+  struct Tile {
+    explicit Tile(const Node& origin);
+
+    Node origin;
+    std::array<uint8_t, cellsPerTileSide * cellsPerTileSide> counts;
+  };
+
+  // Functions for keeping the counts up to date: add counts a head at the given
+  // node, remove uncounts it, and move moves it from one node to another.
+  void add(const Node& node);
+  void remove(const Node& node);
+  void move(const Node& from, const Node& to);
+
+  // Removes all tiles.
+  void clear();
+
+  // Returns the allocated tiles, which may hold only zero counts.
+  const std::vector<std::unique_ptr<Tile>>& tiles() const;
+
+  // Returns the coordinates of the cell containing the given node, and the
+  // index of the given cell within its tile, respectively.
+  static Node cellOf(const Node& node);
+  static int cellIndexOf(const Node& cell);
+
+  // Returns the number of bytes allocated for the tiles and their index.
+  std::size_t memoryUsage() const;
+
+ private:
+  // Returns the tile containing the given cell, allocating it if needed.
+  Tile& tileOf(const Node& cell);
+
+  NodeHashMap<Tile> _index;
+  std::vector<std::unique_ptr<Tile>> _tiles;
+};
+
+inline void DensityMap::move(const Node& from, const Node& to) {
+  // Most movements stay within a cell, and those leave the counts unchanged.
+  const Node fromCell = cellOf(from), toCell = cellOf(to);
+  if (fromCell != toCell) {
+    --tileOf(fromCell).counts[cellIndexOf(fromCell)];
+    ++tileOf(toCell).counts[cellIndexOf(toCell)];
+  }
+}
+
+inline const std::vector<std::unique_ptr<DensityMap::Tile>>&
+DensityMap::tiles() const {
+  return _tiles;
+}
+
+inline Node DensityMap::cellOf(const Node& node) {
+  // Arithmetic shifts round toward negative infinity, so negative coordinates
+  // land in the correct cell.
+  return Node(node.x >> cellShift, node.y >> cellShift);
+}
+
+inline int DensityMap::cellIndexOf(const Node& cell) {
+  static constexpr int mask = cellsPerTileSide - 1;
+  return ((cell.y & mask) << (tileShift - cellShift)) | (cell.x & mask);
+}
+
+inline DensityMap::Tile& DensityMap::tileOf(const Node& cell) {
+  const Node tileNode(cell.x >> (tileShift - cellShift),
+                      cell.y >> (tileShift - cellShift));
+  Tile* tile = _index.find(tileNode);
+  if (tile == nullptr) {
+    _tiles.push_back(std::unique_ptr<Tile>(new Tile(tileNode)));
+    tile = _tiles.back().get();
+    _index.set(tileNode, tile);
+  }
+  return *tile;
+}
+
+#endif  // AMOEBOTSIM_CORE_DENSITYMAP_H_
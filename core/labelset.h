@@ -0,0 +1,175 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a set of port labels (see localparticle.h) stored as a bitmask, where
+// bit i is set if and only if label i is in the set. Label sets are plain
+// values that never allocate, so particles can build, combine, count, and
+// iterate over sets of neighbors on every activation at no cost. Iterating
+// over a label set visits its labels in increasing order.
+
+#ifndef AMOEBOTSIM_CORE_LABELSET_H_
+#define AMOEBOTSIM_CORE_LABELSET_H_
+
+#include <cstdint>
+
+#include <QtGlobal>
+
+class LabelSet {
+ public:
+  // Iterator over the labels of a set, in increasing order.
+  class Iterator {
+   public:
+    explicit Iterator(uint16_t mask);
+
+    int operator*() const;
+    Iterator& operator++();
+    bool operator!=(const Iterator& other) const;
+
+   private:
+    uint16_t _mask;  // The labels not visited yet.
+  };
+
+  // Constructs the empty set, or the set with the given bitmask, respectively.
+  LabelSet();
+  explicit LabelSet(uint16_t mask);
+
+  // Returns the set of labels 0, ..., numLabels - 1.
+  static LabelSet firstLabels(int numLabels);
+
+  // Returns the bitmask of this set.
+  uint16_t mask() const;
+
+  // Functions for querying the set. first returns the smallest label in the
+  // set, or -1 if the set is empty.
+  bool empty() const;
+  int size() const;
+  bool contains(int label) const;
+  int first() const;
+
+  // Functions for modifying the set.
+  void insert(int label);
+  void erase(int label);
+
+  // Set operations: intersection, union, and difference.
+  LabelSet operator&(LabelSet other) const;
+  LabelSet operator|(LabelSet other) const;
+  LabelSet operator-(LabelSet other) const;
+  bool operator==(LabelSet other) const;
+  bool operator!=(LabelSet other) const;
+
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  // Returns the index of the lowest set bit of the given non-zero mask.
+  static int lowestBit(uint16_t mask);
+
+  uint16_t _mask;
+};
+
+inline LabelSet::Iterator::Iterator(uint16_t mask)
+  : _mask(mask) {}
+
+inline int LabelSet::Iterator::operator*() const {
+  return lowestBit(_mask);
+}
+
+inline LabelSet::Iterator& LabelSet::Iterator::operator++() {
+  _mask &= _mask - 1;
+  return *this;
+}
+
+inline bool LabelSet::Iterator::operator!=(const Iterator& other) const {
+  return _mask != other._mask;
+}
+
+inline LabelSet::LabelSet()
+  : _mask(0) {}
+
+inline LabelSet::LabelSet(uint16_t mask)
+  : _mask(mask) {}
+
+inline LabelSet LabelSet::firstLabels(int numLabels) {
+  Q_ASSERT(0 <= numLabels && numLabels <= 16);
+
+  return LabelSet(static_cast<uint16_t>((1u << numLabels) - 1));
+}
+
+inline uint16_t LabelSet::mask() const {
+  return _mask;
+}
+
+inline bool LabelSet::empty() const {
+  return _mask == 0;
+}
+
+inline int LabelSet::size() const {
+  int numLabels = 0;
+  for (uint16_t mask = _mask; mask != 0; mask &= mask - 1) {
+    ++numLabels;
+  }
+  return numLabels;
+}
+
+inline bool LabelSet::contains(int label) const {
+  Q_ASSERT(0 <= label && label < 16);
+
+  return (_mask >> label) & 1;
+}
+
+inline int LabelSet::first() const {
+  return empty() ? -1 : lowestBit(_mask);
+}
+
+inline void LabelSet::insert(int label) {
+  Q_ASSERT(0 <= label && label < 16);
+
+  _mask |= static_cast<uint16_t>(1u << label);
+}
+
+inline void LabelSet::erase(int label) {
+  Q_ASSERT(0 <= label && label < 16);
+
+  _mask &= static_cast<uint16_t>(~(1u << label));
+}
+
+inline LabelSet LabelSet::operator&(LabelSet other) const {
+  return LabelSet(_mask & other._mask);
+}
+
+inline LabelSet LabelSet::operator|(LabelSet other) const {
+  return LabelSet(_mask | other._mask);
+}
+
+inline LabelSet LabelSet::operator-(LabelSet other) const {
+  return LabelSet(_mask & ~other._mask);
+}
+
+inline bool LabelSet::operator==(LabelSet other) const {
+  return _mask == other._mask;
+}
+
+inline bool LabelSet::operator!=(LabelSet other) const {
+  return _mask != other._mask;
+}
+
+inline LabelSet::Iterator LabelSet::begin() const {
+  return Iterator(_mask);
+}
+
+inline LabelSet::Iterator LabelSet::end() const {
+  return Iterator(0);
+}
+
+inline int LabelSet::lowestBit(uint16_t mask) {
+  Q_ASSERT(mask != 0);
+
+  int bit = 0;
+  while (!((mask >> bit) & 1)) {
+    ++bit;
+  }
+  return bit;
+}
+
+#endif  // AMOEBOTSIM_CORE_LABELSET_H_
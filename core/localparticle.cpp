@@ -17,6 +17,15 @@ const std::array<const std::vector<int>, 6> LocalParticle::labels = {
    {2, 3, 4, 5, 6}}
 };
 
+const std::array<LabelSet, 6> LocalParticle::labelSets = {
+  {LabelSet(0x0F8),
+   LabelSet(0x1F0),
+   LabelSet(0x383),
+   LabelSet(0x307),
+   LabelSet(0x20F),
+   LabelSet(0x07C)}
+};
+
 const std::array<int, 6> LocalParticle::contractLabels = {
   {0, 1, 4, 5, 6, 9}
 };
@@ -65,20 +74,28 @@ int LocalParticle::labelToDirAfterExpansion(int label, int expansionDir) const {
 
 const std::vector<int> LocalParticle::uniqueLabels() const {
   std::vector<int> labels;
-  if (isContracted()) {
-    labels = sixLabels;
-  } else { // isExpanded().
-    for (int label = 0; label < 10; ++label) {
-      if (nbrNodeReachedViaLabel(label) !=
-          nbrNodeReachedViaLabel((label + 9) % 10)) {
-        labels.push_back(label);
-      }
-    }
+  for (const int label : uniqueLabelSet()) {
+    labels.push_back(label);
   }
 
   return labels;
 }
 
+LabelSet LocalParticle::uniqueLabelSet() const {
+  if (isContracted()) {
+    return LabelSet::firstLabels(6);
+  }
+
+  // The two nodes adjacent to both the head and the tail are each reached by
+  // two consecutive labels: the last label of one of the nodes and the first
+  // label of the other. Only the former is kept.
+  LabelSet unique = LabelSet::firstLabels(10);
+  unique.erase(labels[tailDir()][0]);
+  unique.erase(labels[(tailDir() + 3) % 6][0]);
+
+  return unique;
+}
+
 const std::vector<int>& LocalParticle::headLabels() const {
   Q_ASSERT(-1 <= globalTailDir && globalTailDir < 6);
 
@@ -91,6 +108,18 @@ const std::vector<int>& LocalParticle::tailLabels() const {
   return labels[(tailDir() + 3) % 6];
 }
 
+LabelSet LocalParticle::headLabelSet() const {
+  Q_ASSERT(-1 <= globalTailDir && globalTailDir < 6);
+
+  return isContracted() ? LabelSet::firstLabels(6) : labelSets[tailDir()];
+}
+
+LabelSet LocalParticle::tailLabelSet() const {
+  Q_ASSERT(isExpanded());
+
+  return labelSets[(tailDir() + 3) % 6];
+}
+
 bool LocalParticle::isHeadLabel(int label) const {
   Q_ASSERT(0 <= label && label < 10);
 
@@ -28,6 +28,7 @@
 #include <array>
 #include <vector>
 
+#include "core/labelset.h"
 #include "core/node.h"
 #include "core/particle.h"
 
@@ -50,21 +51,27 @@ class LocalParticle : public Particle {
   int labelToDirAfterExpansion(int label, int expansionDir) const;
 
   // Returns a list of labels which uniquely address the neighboring nodes.
+  // uniqueLabelSet returns the same labels as a LabelSet, which does not
+  // allocate and should be preferred in code run on every activation.
   const std::vector<int> uniqueLabels() const;
+  LabelSet uniqueLabelSet() const;
 
   // Functions for accessing labels specifically indicent to the head or tail.
   // headLabels (respectively, tailLabels) returns a vector of labels of edges
-  // incident to the particle's head (respectively, tail). isHeadLabel (resp.,
-  // isTailLabel) checks whether the given label is a head (resp., tail) label.
-  // dirToHeadLabel (resp., dirToTailLabel) returns the head (resp., tail) label
-  // of the edge pointing in the given local direction. These conversions will
-  // fail on an expanded particle if dirToHeadLabel (resp., dirToTailLabel) is
-  // called with the local direction from head to tail (resp., tail to head), as
-  // the edge connecting the head and tail is not labelled. headContractionLabel
-  // (resp., tailContractionLabel) returns the label needed to perform a head
-  // (resp., tail) contraction.
+  // incident to the particle's head (respectively, tail), listed
+  // counter-clockwise; headLabelSet and tailLabelSet return them as sets.
+  // isHeadLabel (resp., isTailLabel) checks whether the given label is a head
+  // (resp., tail) label. dirToHeadLabel (resp., dirToTailLabel) returns the
+  // head (resp., tail) label of the edge pointing in the given local direction.
+  // These conversions will fail on an expanded particle if dirToHeadLabel
+  // (resp., dirToTailLabel) is called with the local direction from head to
+  // tail (resp., tail to head), as the edge connecting the head and tail is not
+  // labelled. headContractionLabel (resp., tailContractionLabel) returns the
+  // label needed to perform a head (resp., tail) contraction.
   const std::vector<int>& headLabels() const;
   const std::vector<int>& tailLabels() const;
+  LabelSet headLabelSet() const;
+  LabelSet tailLabelSet() const;
   bool isHeadLabel(int label) const;
   bool isTailLabel(int label) const;
   int dirToHeadLabel(int dir) const;
@@ -125,6 +132,7 @@ class LocalParticle : public Particle {
  private:
   static const std::vector<int> sixLabels;
   static const std::array<const std::vector<int>, 6> labels;
+  static const std::array<LabelSet, 6> labelSets;
   static const std::array<int, 6> contractLabels;
   static const std::array<std::array<int, 10>, 6> labelDir;
 };
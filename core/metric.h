@@ -20,15 +20,17 @@ class Count {
   Count(const QString name);
 
   // Increments the value of this count by the number of events being recorded,
-  // whose default is 1.
-  void record(const unsigned int numEvents = 1);
+  // whose default is 1. Defined inline since counts are recorded on every
+  // particle movement and activation.
+  void record(const unsigned long long numEvents = 1);
 
   // Member variables. The count's name should be human-readable, as it is used
   // to represent this count in the GUI. The value of the count is what is
-  // incremented. History records the count values over time, once per round.
+  // incremented; it is 64 bits wide so that long runs cannot overflow it.
+  // History records the count values over time, once per round.
   const QString _name;
-  unsigned int _value;
-  std::vector<int> _history;
+  unsigned long long _value;
+  std::vector<unsigned long long> _history;
 };
 
 class Measure {
@@ -52,4 +54,8 @@ class Measure {
   std::vector<double> _history;
 };
 
+inline void Count::record(const unsigned long long numEvents) {
+  _value += numEvents;
+}
+
 #endif  // AMOEBOTSIM_CORE_METRIC_H_
@@ -0,0 +1,200 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines an open-addressing hash table from lattice nodes to pointers. Nodes
+// are packed into a single 64-bit key and entries are stored inline in one flat
+// array, so lookups cost a hash and a short linear probe with no per-entry
+// allocation. A null value marks an empty slot, so null cannot be stored.
+
+#ifndef AMOEBOTSIM_CORE_NODEHASHMAP_H_
+#define AMOEBOTSIM_CORE_NODEHASHMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "core/node.h"
+
+template<class T>
+class NodeHashMap {
+ public:
+  // Constructs an empty table with a small initial capacity.
+  NodeHashMap();
+
+  // Returns the value stored at the given node, or nullptr if there is none.
+  T* find(const Node& node) const;
+
+  // Stores the given (non-null) value at the given node, overwriting any value
+  // already stored there.
+  void set(const Node& node, T* value);
+
+  // Removes the value stored at the given node, if any.
+  void erase(const Node& node);
+
+  // Removes all entries without releasing the table's memory.
+  void clear();
+
+  // Returns the number of stored entries.
+  unsigned int size() const;
+
+  // Returns the number of bytes allocated for the table.
+  std::size_t memoryUsage() const;
+
+  // Calls func(node, value) for every stored entry in unspecified order.
+  template<class Func>
+  void forEach(Func func) const;
+
+  // Packs a node into the 64-bit key used by the table and unpacks it again.
+  static uint64_t pack(const Node& node);
+  static Node unpack(uint64_t key);
+
+ private:
+  struct Slot {
+    uint64_t key;
+    T* value;
+  };
+
+  // Returns the home slot of the given key. The multiplier is the 64-bit golden
+  // ratio constant, which spreads nearby lattice coordinates across the table.
+  unsigned int home(uint64_t key) const;
+
+  // Doubles the capacity of the table and reinserts every entry.
+  void grow();
+
+  std::vector<Slot> _slots;
+  unsigned int _mask;
+  unsigned int _size;
+};
+
+template<class T>
+NodeHashMap<T>::NodeHashMap()
+  : _slots(16, Slot{0, nullptr}),
+    _mask(15),
+    _size(0) {}
+
+template<class T>
+inline T* NodeHashMap<T>::find(const Node& node) const {
+  const uint64_t key = pack(node);
+  for (unsigned int i = home(key); ; i = (i + 1) & _mask) {
+    const Slot& slot = _slots[i];
+    if (slot.value == nullptr) {
+      return nullptr;
+    } else if (slot.key == key) {
+      return slot.value;
+    }
+  }
+}
+
+template<class T>
+void NodeHashMap<T>::set(const Node& node, T* value) {
+  Q_ASSERT(value != nullptr);
+
+  // Keep the load factor at or below 1/2 so probe sequences stay short.
+  if (2 * (_size + 1) > _slots.size()) {
+    grow();
+  }
+
+  const uint64_t key = pack(node);
+  for (unsigned int i = home(key); ; i = (i + 1) & _mask) {
+    Slot& slot = _slots[i];
+    if (slot.value == nullptr) {
+      slot.key = key;
+      slot.value = value;
+      ++_size;
+      return;
+    } else if (slot.key == key) {
+      slot.value = value;
+      return;
+    }
+  }
+}
+
+template<class T>
+void NodeHashMap<T>::erase(const Node& node) {
+  const uint64_t key = pack(node);
+  unsigned int i = home(key);
+  while (_slots[i].value != nullptr && _slots[i].key != key) {
+    i = (i + 1) & _mask;
+  }
+  if (_slots[i].value == nullptr) {
+    return;  // Not stored.
+  }
+
+  // Backward-shift deletion: pull later entries of the probe run into the hole
+  // whenever that keeps them reachable from their home slot. This avoids
+  // tombstones, so lookups never slow down after many moves.
+  unsigned int hole = i;
+  for (unsigned int j = (i + 1) & _mask; _slots[j].value != nullptr;
+       j = (j + 1) & _mask) {
+    const unsigned int h = home(_slots[j].key);
+    if (((j - h) & _mask) >= ((j - hole) & _mask)) {
+      _slots[hole] = _slots[j];
+      hole = j;
+    }
+  }
+  _slots[hole] = Slot{0, nullptr};
+  --_size;
+}
+
+template<class T>
+void NodeHashMap<T>::clear() {
+  for (auto& slot : _slots) {
+    slot = Slot{0, nullptr};
+  }
+  _size = 0;
+}
+
+template<class T>
+unsigned int NodeHashMap<T>::size() const {
+  return _size;
+}
+
+template<class T>
+std::size_t NodeHashMap<T>::memoryUsage() const {
+  return _slots.capacity() * sizeof(Slot);
+}
+
+template<class T>
+template<class Func>
+void NodeHashMap<T>::forEach(Func func) const {
+  for (const auto& slot : _slots) {
+    if (slot.value != nullptr) {
+      func(unpack(slot.key), slot.value);
+    }
+  }
+}
+
+template<class T>
+inline uint64_t NodeHashMap<T>::pack(const Node& node) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(node.x)) << 32)
+         | static_cast<uint32_t>(node.y);
+}
+
+template<class T>
+inline Node NodeHashMap<T>::unpack(uint64_t key) {
+  return Node(static_cast<int32_t>(key >> 32),
+              static_cast<int32_t>(key & 0xffffffffu));
+}
+
+template<class T>
+inline unsigned int NodeHashMap<T>::home(uint64_t key) const {
+  return static_cast<unsigned int>((key * 0x9e3779b97f4a7c15ull) >> 32) & _mask;
+}
+
+template<class T>
+void NodeHashMap<T>::grow() {
+  std::vector<Slot> old(2 * _slots.size(), Slot{0, nullptr});
+  old.swap(_slots);
+  _mask = _slots.size() - 1;
+  _size = 0;
+  for (const auto& slot : old) {
+    if (slot.value != nullptr) {
+      set(unpack(slot.key), slot.value);
+    }
+  }
+}
+
+#endif  // AMOEBOTSIM_CORE_NODEHASHMAP_H_
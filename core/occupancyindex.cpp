@@ -0,0 +1,76 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/occupancyindex.h"
+
+#include <QtGlobal>
+
+OccupancyIndex::OccupancyIndex(Backend backend)
+  : _backend(backend),
+    _numTiledParticleNodes(0) {}
+
+OccupancyIndex::Backend OccupancyIndex::backend() const {
+  return _backend;
+}
+
+void OccupancyIndex::setObject(const Node& node, ImmoParticle* object) {
+  Q_ASSERT((reinterpret_cast<uintptr_t>(object) & TileGrid::objectTag) == 0);
+
+  if (_backend == Backend::Tiled) {
+    if (particleAt(node) != nullptr) {
+      --_numTiledParticleNodes;
+    }
+    _tiles.setCell(node,
+                   reinterpret_cast<uintptr_t>(object) | TileGrid::objectTag);
+  } else if (_backend == Backend::Hashed) {
+    _hashedObjects.set(node, object);
+  } else {
+    _orderedObjects[node] = object;
+  }
+}
+
+unsigned int OccupancyIndex::numParticleNodes() const {
+  switch (_backend) {
+    case Backend::Ordered:  return _orderedParticles.size();
+    case Backend::Hashed:   return _hashedParticles.size();
+    default:                return _numTiledParticleNodes;
+  }
+}
+
+std::size_t OccupancyIndex::memoryUsage() const {
+  switch (_backend) {
+    case Backend::Ordered: {
+      // Each map node holds its entry, three pointers, and a color.
+      const std::size_t nodeOverhead = 4 * sizeof(void*);
+      return _orderedParticles.size() *
+                 (sizeof(std::pair<const Node, AmoebotParticle*>) +
+                  nodeOverhead) +
+             _orderedObjects.size() *
+                 (sizeof(std::pair<const Node, ImmoParticle*>) +
+                  nodeOverhead);
+    }
+    case Backend::Hashed:
+      return _hashedParticles.memoryUsage() + _hashedObjects.memoryUsage();
+    default:
+      return _tiles.memoryUsage();
+  }
+}
+
+QString OccupancyIndex::backendName(Backend backend) {
+  switch (backend) {
+    case Backend::Ordered:  return "ordered";
+    case Backend::Hashed:   return "hashed";
+    default:                return "tiled";
+  }
+}
+
+OccupancyIndex::Backend OccupancyIndex::backendFromName(const QString& name) {
+  if (name == "ordered") {
+    return Backend::Ordered;
+  } else if (name == "hashed") {
+    return Backend::Hashed;
+  } else {
+    return Backend::Tiled;
+  }
+}
@@ -0,0 +1,165 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the index an AmoebotSystem uses to answer "which particle (or object)
+// occupies this node?". The backend is chosen when the system is constructed:
+// Ordered keeps the original std::map implementation around as a reference,
+// Hashed uses flat open-addressing tables (see nodehashmap.h) that make every
+// neighbor probe O(1) without pointer chasing, and Tiled stores particles and
+// objects together in dense lattice tiles (see tilegrid.h) so that checking
+// whether a node is free takes a single lookup.
+
+#ifndef AMOEBOTSIM_CORE_OCCUPANCYINDEX_H_
+#define AMOEBOTSIM_CORE_OCCUPANCYINDEX_H_
+
+#include <cstddef>
+#include <map>
+
+#include <QString>
+
+#include "core/node.h"
+#include "core/nodehashmap.h"
+#include "core/tilegrid.h"
+
+// AmoebotParticle and ImmoParticle are only stored by pointer, so they are
+// forward declared to avoid a cyclic dependency with amoebotsystem.h.
+class AmoebotParticle;
+class ImmoParticle;
+
+class OccupancyIndex {
+ public:
+  enum class Backend {
+    Ordered,  // std::map keyed by Node's operator<; O(log n) per probe.
+    Hashed,   // Open-addressing hash table; O(1) expected per probe.
+    Tiled     // Dense tiles shared by particles and objects; O(1) per probe.
+  };
+
+  // Constructs an empty index using the given backend.
+  explicit OccupancyIndex(Backend backend = Backend::Tiled);
+
+  // Returns the backend this index was constructed with.
+  Backend backend() const;
+
+  // Returns the particle (resp., object) occupying the given node, or nullptr
+  // if the node holds no particle (resp., object).
+  AmoebotParticle* particleAt(const Node& node) const;
+  ImmoParticle* objectAt(const Node& node) const;
+
+  // Returns true if and only if the given node holds a particle or an object.
+  bool isOccupied(const Node& node) const;
+
+  // Functions for updating the index. setParticle (resp., setObject) records
+  // that the given particle (resp., object) occupies the given node, replacing
+  // any previous occupant. eraseParticle clears the particle entry of the node.
+  void setParticle(const Node& node, AmoebotParticle* particle);
+  void eraseParticle(const Node& node);
+  void setObject(const Node& node, ImmoParticle* object);
+
+  // Returns the number of nodes occupied by particles.
+  unsigned int numParticleNodes() const;
+
+  // Returns the number of bytes allocated by this index. For the ordered
+  // backend this is an estimate, since the size of a std::map node is not
+  // exposed.
+  std::size_t memoryUsage() const;
+
+  // Calls func(node, particle) for every node occupied by a particle.
+  template<class Func>
+  void forEachParticleNode(Func func) const;
+
+  // Converts between a backend and its name ("ordered", "hashed", or "tiled").
+  // Unknown names map to the tiled backend.
+  static QString backendName(Backend backend);
+  static Backend backendFromName(const QString& name);
+
+ private:
+  const Backend _backend;
+  std::map<Node, AmoebotParticle*> _orderedParticles;
+  std::map<Node, ImmoParticle*> _orderedObjects;
+  NodeHashMap<AmoebotParticle> _hashedParticles;
+  NodeHashMap<ImmoParticle> _hashedObjects;
+  TileGrid _tiles;
+  unsigned int _numTiledParticleNodes;
+};
+
+inline AmoebotParticle* OccupancyIndex::particleAt(const Node& node) const {
+  if (_backend == Backend::Tiled) {
+    const uintptr_t cell = _tiles.cellAt(node);
+    return (cell & TileGrid::objectTag)
+        ? nullptr : reinterpret_cast<AmoebotParticle*>(cell);
+  } else if (_backend == Backend::Hashed) {
+    return _hashedParticles.find(node);
+  } else {
+    auto it = _orderedParticles.find(node);
+    return (it == _orderedParticles.end()) ? nullptr : it->second;
+  }
+}
+
+inline ImmoParticle* OccupancyIndex::objectAt(const Node& node) const {
+  if (_backend == Backend::Tiled) {
+    const uintptr_t cell = _tiles.cellAt(node);
+    return (cell & TileGrid::objectTag)
+        ? reinterpret_cast<ImmoParticle*>(cell & ~TileGrid::objectTag)
+        : nullptr;
+  } else if (_backend == Backend::Hashed) {
+    return _hashedObjects.find(node);
+  } else {
+    auto it = _orderedObjects.find(node);
+    return (it == _orderedObjects.end()) ? nullptr : it->second;
+  }
+}
+
+inline bool OccupancyIndex::isOccupied(const Node& node) const {
+  if (_backend == Backend::Tiled) {
+    return _tiles.cellAt(node) != TileGrid::emptyCell;
+  } else {
+    return particleAt(node) != nullptr || objectAt(node) != nullptr;
+  }
+}
+
+inline void OccupancyIndex::setParticle(const Node& node,
+                                        AmoebotParticle* particle) {
+  if (_backend == Backend::Tiled) {
+    if (particleAt(node) == nullptr) {
+      ++_numTiledParticleNodes;
+    }
+    _tiles.setCell(node, reinterpret_cast<uintptr_t>(particle));
+  } else if (_backend == Backend::Hashed) {
+    _hashedParticles.set(node, particle);
+  } else {
+    _orderedParticles[node] = particle;
+  }
+}
+
+inline void OccupancyIndex::eraseParticle(const Node& node) {
+  if (_backend == Backend::Tiled) {
+    if (particleAt(node) != nullptr) {
+      --_numTiledParticleNodes;
+      _tiles.setCell(node, TileGrid::emptyCell);
+    }
+  } else if (_backend == Backend::Hashed) {
+    _hashedParticles.erase(node);
+  } else {
+    _orderedParticles.erase(node);
+  }
+}
+
+template<class Func>
+void OccupancyIndex::forEachParticleNode(Func func) const {
+  if (_backend == Backend::Tiled) {
+    _tiles.forEachCell([&](const Node& node, uintptr_t cell) {
+      if (!(cell & TileGrid::objectTag)) {
+        func(node, reinterpret_cast<AmoebotParticle*>(cell));
+      }
+    });
+  } else if (_backend == Backend::Hashed) {
+    _hashedParticles.forEach(func);
+  } else {
+    for (const auto& entry : _orderedParticles) {
+      func(entry.first, entry.second);
+    }
+  }
+}
+
+#endif  // AMOEBOTSIM_CORE_OCCUPANCYINDEX_H_
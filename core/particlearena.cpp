@@ -0,0 +1,89 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/particlearena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+
+// Chunks come from ::operator new, which aligns them for any type; blocks are
+// multiples of this alignment, so every block is aligned as well.
+constexpr std::size_t blockAlignment = alignof(std::max_align_t);
+constexpr std::size_t firstChunkSize = 16 * 1024;
+constexpr std::size_t maxChunkSize = 16 * 1024 * 1024;
+
+}  // namespace
+
+ParticleArena::ParticleArena()
+  : _used(0) {}
+
+ParticleArena::~ParticleArena() {
+  for (const Chunk& chunk : _chunks) {
+    ::operator delete(chunk.data);
+  }
+}
+
+void* ParticleArena::allocate(std::size_t bytes) {
+  bytes = roundUp(bytes);
+  for (auto& freeList : _freeLists) {
+    if (freeList.first == bytes && freeList.second != nullptr) {
+      void* block = freeList.second;
+      freeList.second = *static_cast<void**>(block);
+      return block;
+    }
+  }
+
+  if (_chunks.empty() || _used + bytes > _chunks.back().size) {
+    std::size_t size = _chunks.empty()
+                       ? firstChunkSize
+                       : std::min(2 * _chunks.back().size, maxChunkSize);
+    size = std::max(size, bytes);
+    _chunks.push_back({static_cast<char*>(::operator new(size)), size});
+    _used = 0;
+  }
+
+  void* block = _chunks.back().data + _used;
+  _used += bytes;
+  return block;
+}
+
+void ParticleArena::release(void* block, std::size_t bytes) {
+  bytes = roundUp(bytes);
+  for (auto& freeList : _freeLists) {
+    if (freeList.first == bytes) {
+      *static_cast<void**>(block) = freeList.second;
+      freeList.second = block;
+      return;
+    }
+  }
+
+  *static_cast<void**>(block) = nullptr;
+  _freeLists.emplace_back(bytes, block);
+}
+
+bool ParticleArena::owns(const void* address) const {
+  const char* byte = static_cast<const char*>(address);
+  for (const Chunk& chunk : _chunks) {
+    if (chunk.data <= byte && byte < chunk.data + chunk.size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t ParticleArena::memoryUsage() const {
+  std::size_t bytes = _chunks.capacity() * sizeof(Chunk) +
+                      _freeLists.capacity() * sizeof(_freeLists[0]);
+  for (const Chunk& chunk : _chunks) {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
+
+std::size_t ParticleArena::roundUp(std::size_t bytes) {
+  bytes = std::max(bytes, sizeof(void*));
+  return (bytes + blockAlignment - 1) / blockAlignment * blockAlignment;
+}
@@ -0,0 +1,68 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the arena in which an AmoebotSystem stores the particles and objects
+// it constructs itself (see AmoebotSystem::emplace). Blocks are carved
+// consecutively out of large chunks, so particles inserted one after another
+// lie next to each other in memory, and all chunks are freed at once when the
+// arena is destructed instead of freeing every block on its own. Chunks double
+// in size up to a limit, so a system of n particles uses O(log n) chunks while
+// small systems stay small.
+//
+// Released blocks (i.e., of particles removed from a running system) are kept
+// in one free list per block size and handed out again by later allocations of
+// the same size. The arena does not construct or destruct anything; that is up
+// to its owner.
+
+#ifndef AMOEBOTSIM_CORE_PARTICLEARENA_H_
+#define AMOEBOTSIM_CORE_PARTICLEARENA_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class ParticleArena {
+ public:
+  // Constructs an empty arena, which allocates no memory until its first
+  // allocation.
+  ParticleArena();
+
+  // Frees all chunks of this arena, including all blocks still in use.
+  ~ParticleArena();
+
+  ParticleArena(const ParticleArena&) = delete;
+  ParticleArena& operator=(const ParticleArena&) = delete;
+
+  // Returns a block of at least the given number of bytes, aligned for any
+  // type. release returns a block to the arena for reuse; bytes must be the
+  // number of bytes the block was allocated with.
+  void* allocate(std::size_t bytes);
+  void release(void* block, std::size_t bytes);
+
+  // Returns true if and only if the given address lies in one of the chunks of
+  // this arena. Takes time linear in the number of chunks.
+  bool owns(const void* address) const;
+
+  // Returns the number of bytes held by the chunks of this arena.
+  std::size_t memoryUsage() const;
+
+ private:
+  struct Chunk {
+    char* data;
+    std::size_t size;
+  };
+
+  // Rounds the given number of bytes up to a multiple of the alignment.
+  static std::size_t roundUp(std::size_t bytes);
+
+  std::vector<Chunk> _chunks;
+  std::size_t _used;  // Bytes handed out from the last chunk.
+
+  // Pairs of a (rounded) block size and the first free block of that size;
+  // each free block stores a pointer to the next one. Systems rarely hold more
+  // than a few particle types, so a linear scan is enough.
+  std::vector<std::pair<std::size_t, void*>> _freeLists;
+};
+
+#endif  // AMOEBOTSIM_CORE_PARTICLEARENA_H_
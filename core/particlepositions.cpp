@@ -0,0 +1,60 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/particlepositions.h"
+
+#include <QtGlobal>
+
+void ParticlePositions::append(const Node& head, int tailDir,
+                               int orientation) {
+  if (_densityMap != nullptr) {
+    _densityMap->add(head);
+  }
+  _headX.push_back(head.x);
+  _headY.push_back(head.y);
+  _tailDir.push_back(static_cast<int8_t>(tailDir));
+  _orientation.push_back(static_cast<int8_t>(orientation));
+}
+
+void ParticlePositions::moveLastTo(unsigned int i) {
+  Q_ASSERT(i < size());
+
+  if (_densityMap != nullptr) {
+    _densityMap->remove(headNode(i));
+  }
+  _headX[i] = _headX.back();
+  _headY[i] = _headY.back();
+  _tailDir[i] = _tailDir.back();
+  _orientation[i] = _orientation.back();
+  _headX.pop_back();
+  _headY.pop_back();
+  _tailDir.pop_back();
+  _orientation.pop_back();
+}
+
+void ParticlePositions::clear() {
+  _headX.clear();
+  _headY.clear();
+  _tailDir.clear();
+  _orientation.clear();
+  if (_densityMap != nullptr) {
+    _densityMap->clear();
+  }
+}
+
+const DensityMap& ParticlePositions::densityMap() const {
+  if (_densityMap == nullptr) {
+    _densityMap.reset(new DensityMap());
+    for (unsigned int i = 0; i < size(); ++i) {
+      _densityMap->add(headNode(i));
+    }
+  }
+  return *_densityMap;
+}
+
+std::size_t ParticlePositions::memoryUsage() const {
+  return (_headX.capacity() + _headY.capacity()) * sizeof(int) +
+         (_tailDir.capacity() + _orientation.capacity()) * sizeof(int8_t) +
+         ((_densityMap != nullptr) ? _densityMap->memoryUsage() : 0);
+}
@@ -0,0 +1,121 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a structure-of-arrays copy of the particles' positions kept by an
+// AmoebotSystem: the head coordinates, global tail direction, and orientation
+// of the particle at index i of the system's particle list are stored at index
+// i of contiguous arrays. The system updates the arrays when particles are
+// inserted or removed, and the movement functions of AmoebotParticle update
+// them whenever a head or tail direction changes, so they always agree with the
+// particles. Code that only needs positions (measures, rendering, statistics)
+// can thus loop over these arrays instead of dereferencing every particle.
+//
+// Particles must not change their head or globalTailDir other than through the
+// movement functions of AmoebotParticle.
+//
+// On request, the positions also maintain a density map of the heads (see
+// densitymap.h), which they update along with the arrays from then on.
+
+#ifndef AMOEBOTSIM_CORE_PARTICLEPOSITIONS_H_
+#define AMOEBOTSIM_CORE_PARTICLEPOSITIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/densitymap.h"
+#include "core/node.h"
+
+class ParticlePositions {
+ public:
+  // Returns the number of particles.
+  unsigned int size() const;
+
+  // The arrays themselves: the x and y coordinates of each particle's head, its
+  // global tail direction (-1 if contracted), and its orientation.
+  const std::vector<int>& headX() const;
+  const std::vector<int>& headY() const;
+  const std::vector<int8_t>& tailDir() const;
+  const std::vector<int8_t>& orientation() const;
+
+  // Convenience functions for the particle at the given index. headNode and
+  // tailNode return the nodes occupied by its head and tail, where the tail
+  // node of a contracted particle is its head node.
+  Node headNode(unsigned int i) const;
+  Node tailNode(unsigned int i) const;
+  bool isExpanded(unsigned int i) const;
+
+  // Functions for keeping the arrays in sync with the system's particle list.
+  // append adds a particle at the end, update overwrites the position of the
+  // particle at the given index, and moveLastTo overwrites the given index with
+  // the last particle and removes the last entry, mirroring a swap-and-pop
+  // removal from the particle list.
+  void append(const Node& head, int tailDir, int orientation);
+  void update(unsigned int i, const Node& head, int tailDir);
+  void moveLastTo(unsigned int i);
+  void clear();
+
+  // Returns the density map of the heads. The map is built on the first call
+  // and kept up to date from then on, so that systems never drawn at a low zoom
+  // (see VisItem) never pay for it.
+  const DensityMap& densityMap() const;
+
+  // Returns the number of bytes allocated for the arrays and the density map.
+  std::size_t memoryUsage() const;
+
+ private:
+  std::vector<int> _headX;
+  std::vector<int> _headY;
+  std::vector<int8_t> _tailDir;
+  std::vector<int8_t> _orientation;
+
+  // Built lazily by the const function densityMap, hence mutable.
+  mutable std::unique_ptr<DensityMap> _densityMap;
+};
+
+inline unsigned int ParticlePositions::size() const {
+  return _headX.size();
+}
+
+inline const std::vector<int>& ParticlePositions::headX() const {
+  return _headX;
+}
+
+inline const std::vector<int>& ParticlePositions::headY() const {
+  return _headY;
+}
+
+inline const std::vector<int8_t>& ParticlePositions::tailDir() const {
+  return _tailDir;
+}
+
+inline const std::vector<int8_t>& ParticlePositions::orientation() const {
+  return _orientation;
+}
+
+inline Node ParticlePositions::headNode(unsigned int i) const {
+  return Node(_headX[i], _headY[i]);
+}
+
+inline Node ParticlePositions::tailNode(unsigned int i) const {
+  return (_tailDir[i] == -1) ? headNode(i)
+                              : headNode(i).nodeInDir(_tailDir[i]);
+}
+
+inline bool ParticlePositions::isExpanded(unsigned int i) const {
+  return _tailDir[i] != -1;
+}
+
+inline void ParticlePositions::update(unsigned int i, const Node& head,
+                                      int tailDir) {
+  if (_densityMap != nullptr) {
+    _densityMap->move(headNode(i), head);
+  }
+  _headX[i] = head.x;
+  _headY[i] = head.y;
+  _tailDir[i] = static_cast<int8_t>(tailDir);
+}
+
+#endif  // AMOEBOTSIM_CORE_PARTICLEPOSITIONS_H_
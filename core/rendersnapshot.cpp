@@ -0,0 +1,190 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/rendersnapshot.h"
+
+#include <array>
+#include <utility>
+
+#include "core/immoparticle.h"
+#include "core/particle.h"
+#include "core/particlepositions.h"
+#include "core/system.h"
+
+constexpr int RenderSnapshot::tileShift;
+
+RenderSnapshot::RenderSnapshot()
+  : _isDensity(false) {}
+
+void RenderSnapshot::capture(const System& system) {
+  _borders.clear();
+  _borderPoints.clear();
+  _tiles.clear();
+  _tileIndex.clear();
+  _entryTiles.clear();
+  _isDensity = false;
+  _densityTiles.clear();
+  _densityIndex.clear();
+
+  // Count the particles and objects of every tile, remembering the tile of
+  // each of them, and lay the tiles out one after another.
+  const ParticlePositions& positions = system.positions();
+  const std::deque<ImmoParticle*>& objects = system.getImmoParticles();
+  auto tileFor = [this](const Node& node) {
+    const Node tileNode = tileOf(node);
+    Tile* tile = _tileIndex.find(tileNode);
+    if (tile == nullptr) {
+      _tiles.push_back(Tile{tileNode, 0, 0, 0, 0});
+      tile = &_tiles.back();
+      _tileIndex.set(tileNode, tile);
+    }
+    return tile;
+  };
+  for (unsigned int i = 0; i < positions.size(); ++i) {
+    Tile* tile = tileFor(positions.headNode(i));
+    ++tile->numParticles;
+    _entryTiles.push_back(tile);
+  }
+  for (const ImmoParticle* obj : objects) {
+    Tile* tile = tileFor(obj->_node);
+    ++tile->numObjects;
+    _entryTiles.push_back(tile);
+  }
+  uint32_t numParticles = 0, numObjects = 0;
+  for (Tile& tile : _tiles) {
+    tile.firstParticle = numParticles;
+    tile.firstObject = numObjects;
+    numParticles += tile.numParticles;
+    numObjects += tile.numObjects;
+    tile.numParticles = 0;
+    tile.numObjects = 0;
+  }
+
+  // Capture every particle and object into the next free entry of its tile.
+  _particles.resize(positions.size());
+  for (unsigned int i = 0; i < positions.size(); ++i) {
+    const Particle& p = system.at(i);
+    Tile* tile = _entryTiles[i];
+    ParticleState& state =
+        _particles[tile->firstParticle + tile->numParticles++];
+    state.head = positions.headNode(i);
+    state.tailDir = positions.tailDir()[i];
+    state.headMarkColor = p.headMarkColor();
+    state.tailMarkColor = p.tailMarkColor();
+    state.headMarkDir = static_cast<int8_t>(p.headMarkGlobalDir());
+    state.tailMarkDir = static_cast<int8_t>(p.tailMarkGlobalDir());
+
+    const std::array<int, 18> borderColors = p.borderColors();
+    state.firstBorder = static_cast<uint32_t>(_borders.size());
+    for (unsigned int j = 0; j < borderColors.size(); ++j) {
+      if (borderColors[j] != -1) {
+        _borders.push_back({borderColors[j], static_cast<uint8_t>(j)});
+      }
+    }
+    state.numBorders =
+        static_cast<uint8_t>(_borders.size() - state.firstBorder);
+
+    const std::array<int, 6> borderPointColors = p.borderPointColors();
+    state.firstBorderPoint = static_cast<uint32_t>(_borderPoints.size());
+    for (unsigned int j = 0; j < borderPointColors.size(); ++j) {
+      if (borderPointColors[j] != -1) {
+        _borderPoints.push_back({borderPointColors[j],
+                                 static_cast<uint8_t>(j)});
+      }
+    }
+    state.numBorderPoints =
+        static_cast<uint8_t>(_borderPoints.size() - state.firstBorderPoint);
+  }
+
+  _objects.resize(objects.size());
+  for (unsigned int i = 0; i < objects.size(); ++i) {
+    Tile* tile = _entryTiles[positions.size() + i];
+    _objects[tile->firstObject + tile->numObjects++] = objects[i]->_node;
+  }
+}
+
+void RenderSnapshot::captureDensity(const System& system) {
+  _particles.clear();
+  _borders.clear();
+  _borderPoints.clear();
+  _objects.clear();
+  _tiles.clear();
+  _tileIndex.clear();
+  _isDensity = true;
+  _densityTiles.clear();
+  _densityIndex.clear();
+
+  auto tileFor = [this](const Node& tileNode) {
+    DensityTile* tile = _densityIndex.find(tileNode);
+    if (tile == nullptr) {
+      _densityTiles.push_back(DensityTile());
+      tile = &_densityTiles.back();
+      tile->origin = tileNode;
+      tile->particles.fill(0);
+      tile->objects.fill(0);
+      _densityIndex.set(tileNode, tile);
+    }
+    return tile;
+  };
+
+  // Copy the particle counts of the tiles that hold any particles.
+  for (const auto& mapTile : system.positions().densityMap().tiles()) {
+    for (uint8_t count : mapTile->counts) {
+      if (count != 0) {
+        tileFor(mapTile->origin)->particles = mapTile->counts;
+        break;
+      }
+    }
+  }
+
+  // Objects never move, so they are counted here rather than in a map.
+  for (const ImmoParticle* obj : system.getImmoParticles()) {
+    const Node cell = DensityMap::cellOf(obj->_node);
+    DensityTile* tile = tileFor(tileOf(obj->_node));
+    ++tile->objects[DensityMap::cellIndexOf(cell)];
+  }
+}
+
+std::size_t RenderSnapshot::memoryUsage() const {
+  return _particles.capacity() * sizeof(ParticleState) +
+         (_borders.capacity() + _borderPoints.capacity()) *
+             sizeof(BorderState) +
+         _objects.capacity() * sizeof(Node) +
+         _tiles.size() * sizeof(Tile) + _tileIndex.memoryUsage() +
+         _entryTiles.capacity() * sizeof(Tile*) +
+         _densityTiles.size() * sizeof(DensityTile) +
+         _densityIndex.memoryUsage();
+}
+
+RenderSnapshotBuffer::RenderSnapshotBuffer()
+  : _latest(nullptr),
+    _spare(nullptr) {}
+
+RenderSnapshotBuffer::~RenderSnapshotBuffer() {
+  delete _latest.load();
+  delete _spare.load();
+}
+
+std::unique_ptr<RenderSnapshot> RenderSnapshotBuffer::acquire() {
+  std::unique_ptr<RenderSnapshot> snapshot(_spare.exchange(nullptr));
+  if (snapshot == nullptr) {
+    snapshot.reset(new RenderSnapshot());
+  }
+  return snapshot;
+}
+
+void RenderSnapshotBuffer::publish(std::unique_ptr<RenderSnapshot> snapshot) {
+  std::unique_ptr<RenderSnapshot> stale(_latest.exchange(snapshot.release()));
+  recycle(std::move(stale));
+}
+
+std::unique_ptr<RenderSnapshot> RenderSnapshotBuffer::takeLatest() {
+  return std::unique_ptr<RenderSnapshot>(_latest.exchange(nullptr));
+}
+
+void RenderSnapshotBuffer::recycle(std::unique_ptr<RenderSnapshot> snapshot) {
+  if (snapshot != nullptr) {
+    delete _spare.exchange(snapshot.release());
+  }
+}
@@ -0,0 +1,225 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a render snapshot, a compact copy of everything the visualization
+// draws of a system: the position, tail direction, and mark and border colors
+// of every particle, and the nodes of the objects. The simulator captures a
+// snapshot at frame boundaries while it holds the system's mutex and publishes
+// it through the system's RenderSnapshotBuffer; the renderer then draws from
+// the latest published snapshot without ever touching the system or its mutex,
+// so drawing a frame never holds up the simulation.
+//
+// The snapshot groups the particles and objects into tiles of 16x16 lattice
+// nodes by the node they occupy (the head, for particles), so that the renderer
+// can look up the ones in the visible part of the lattice instead of going
+// through all of them.
+//
+// For drawing a large system from far away, a snapshot can instead capture the
+// densities of the system (see captureDensity), which take time and space
+// proportional to the number of tiles rather than the number of particles.
+
+#ifndef AMOEBOTSIM_CORE_RENDERSNAPSHOT_H_
+#define AMOEBOTSIM_CORE_RENDERSNAPSHOT_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "core/densitymap.h"
+#include "core/node.h"
+#include "core/nodehashmap.h"
+
+class System;
+
+class RenderSnapshot {
+ public:
+  // The appearance of a particle, as returned by the functions of Particle at
+  // the time of capture. Colors are in 0xrrggbb format, where -1 indicates no
+  // color, and directions are global, where -1 indicates none. The particle's
+  // colored border segments and border points are the entries firstBorder, ...,
+  // firstBorder + numBorders - 1 of borders() and firstBorderPoint, ...,
+  // firstBorderPoint + numBorderPoints - 1 of borderPoints(), respectively.
+  struct ParticleState {
+    Node head;
+    int headMarkColor;
+    int tailMarkColor;
+    uint32_t firstBorder;
+    uint32_t firstBorderPoint;
+    int8_t tailDir;
+    int8_t headMarkDir;
+    int8_t tailMarkDir;
+    uint8_t numBorders;
+    uint8_t numBorderPoints;
+  };
+
+  // A colored border segment (index 0-17, see Particle::borderColors) or border
+  // point (index 0-5, see Particle::borderPointColors) of a particle.
+  struct BorderState {
+    int color;
+    uint8_t index;
+  };
+
+  // The tile with coordinates origin = (tx, ty) consists of the nodes (x, y)
+  // with tileOf(Node(x, y)) == Node(tx, ty). Its particles are the entries
+  // firstParticle, ..., firstParticle + numParticles - 1 of particles(), and
+  // its objects are the entries firstObject, ..., firstObject + numObjects - 1
+  // of objects().
+  static constexpr int tileShift = DensityMap::tileShift;
+  struct Tile {
+    Node origin;
+    uint32_t firstParticle;
+    uint32_t numParticles;
+    uint32_t firstObject;
+    uint32_t numObjects;
+  };
+
+  // The densities of a tile: the number of particle heads and objects in each
+  // of its cells of 4x4 nodes, indexed like the counts of DensityMap::Tile.
+  struct DensityTile {
+    Node origin;
+    std::array<uint8_t, DensityMap::cellsPerTileSide *
+                        DensityMap::cellsPerTileSide> particles;
+    std::array<uint8_t, DensityMap::cellsPerTileSide *
+                        DensityMap::cellsPerTileSide> objects;
+  };
+
+  // Constructs an empty snapshot.
+  RenderSnapshot();
+
+  // Replaces the contents of this snapshot with the current state of the given
+  // system, reusing the storage of the previous contents. The caller must hold
+  // the system's mutex.
+  void capture(const System& system);
+
+  // Replaces the contents of this snapshot with the densities of the given
+  // system, leaving the particles, borders, objects, and tiles empty. The
+  // particle densities come from the system's density map, which is updated
+  // incrementally as particles move. The caller must hold the system's mutex.
+  void captureDensity(const System& system);
+
+  // Returns true if and only if this snapshot holds densities rather than
+  // particles.
+  bool isDensity() const;
+
+  // The captured particles, their colored borders and border points, and the
+  // nodes of the objects. Particles and objects are ordered tile by tile.
+  const std::vector<ParticleState>& particles() const;
+  const std::vector<BorderState>& borders() const;
+  const std::vector<BorderState>& borderPoints() const;
+  const std::vector<Node>& objects() const;
+
+  // Returns the coordinates of the tile containing the given node, and the
+  // tile with the given coordinates (nullptr if it holds no particle or
+  // object), respectively.
+  static Node tileOf(const Node& node);
+  const Tile* tileAt(const Node& tile) const;
+  const std::deque<Tile>& tiles() const;
+
+  // Returns the tiles holding particles or objects, with their densities, if
+  // this snapshot holds densities.
+  const std::deque<DensityTile>& densityTiles() const;
+
+  // Returns the number of bytes allocated for the snapshot.
+  std::size_t memoryUsage() const;
+
+ private:
+  std::vector<ParticleState> _particles;
+  std::vector<BorderState> _borders;
+  std::vector<BorderState> _borderPoints;
+  std::vector<Node> _objects;
+
+  // The non-empty tiles and their index by tile coordinates. _entryTiles is
+  // scratch space used by capture, holding the tile of each particle and
+  // object in the order of the system.
+  std::deque<Tile> _tiles;
+  NodeHashMap<Tile> _tileIndex;
+  std::vector<Tile*> _entryTiles;
+
+  bool _isDensity;
+  std::deque<DensityTile> _densityTiles;
+  NodeHashMap<DensityTile> _densityIndex;
+};
+
+// Hands render snapshots from the simulation thread to the render thread
+// without locks. Snapshots change owners by atomically exchanging pointers in
+// two slots: the latest published snapshot, which the renderer takes, and a
+// spare snapshot the renderer is done with, whose storage the simulation reuses
+// for the next capture. At most four snapshots exist at a time (the one being
+// captured, the latest, the spare, and the one being drawn), so publishing
+// never allocates once the sizes have settled.
+class RenderSnapshotBuffer {
+ public:
+  RenderSnapshotBuffer();
+  ~RenderSnapshotBuffer();
+
+  RenderSnapshotBuffer(const RenderSnapshotBuffer&) = delete;
+  RenderSnapshotBuffer& operator=(const RenderSnapshotBuffer&) = delete;
+
+  // Simulation side. acquire returns a snapshot to capture into, recycled from
+  // the spare slot if possible, and publish makes a captured snapshot the
+  // latest one. A published snapshot the renderer has not taken yet becomes
+  // the spare.
+  std::unique_ptr<RenderSnapshot> acquire();
+  void publish(std::unique_ptr<RenderSnapshot> snapshot);
+
+  // Render side. takeLatest returns the latest published snapshot and empties
+  // its slot, or returns nullptr if nothing was published since the last call.
+  // recycle hands back a snapshot the renderer no longer draws (nullptr is
+  // ignored).
+  std::unique_ptr<RenderSnapshot> takeLatest();
+  void recycle(std::unique_ptr<RenderSnapshot> snapshot);
+
+ private:
+  std::atomic<RenderSnapshot*> _latest;
+  std::atomic<RenderSnapshot*> _spare;
+};
+
+inline const std::vector<RenderSnapshot::ParticleState>&
+RenderSnapshot::particles() const {
+  return _particles;
+}
+
+inline const std::vector<RenderSnapshot::BorderState>&
+RenderSnapshot::borders() const {
+  return _borders;
+}
+
+inline const std::vector<RenderSnapshot::BorderState>&
+RenderSnapshot::borderPoints() const {
+  return _borderPoints;
+}
+
+inline const std::vector<Node>& RenderSnapshot::objects() const {
+  return _objects;
+}
+
+inline Node RenderSnapshot::tileOf(const Node& node) {
+  // Arithmetic shifts round toward negative infinity, so negative coordinates
+  // land in the correct tile.
+  return Node(node.x >> tileShift, node.y >> tileShift);
+}
+
+inline const RenderSnapshot::Tile* RenderSnapshot::tileAt(
+    const Node& tile) const {
+  return _tileIndex.find(tile);
+}
+
+inline const std::deque<RenderSnapshot::Tile>& RenderSnapshot::tiles() const {
+  return _tiles;
+}
+
+inline bool RenderSnapshot::isDensity() const {
+  return _isDensity;
+}
+
+inline const std::deque<RenderSnapshot::DensityTile>&
+RenderSnapshot::densityTiles() const {
+  return _densityTiles;
+}
+
+#endif  // AMOEBOTSIM_CORE_RENDERSNAPSHOT_H_
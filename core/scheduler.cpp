@@ -0,0 +1,154 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/scheduler.h"
+
+#include <atomic>
+#include <cmath>
+
+#include <QtGlobal>
+
+const unsigned int Scheduler::none;
+
+thread_local bool Scheduler::_hasNextPolicy = false;
+thread_local Scheduler::Policy Scheduler::_nextPolicy =
+    Scheduler::Policy::Uniform;
+
+namespace {
+
+// The policy of schedulers constructed by takeNextPolicy when no policy was set.
+std::atomic<int> defaultPolicyKind(
+    static_cast<int>(Scheduler::Policy::Uniform));
+
+}  // namespace
+
+Scheduler::Scheduler(Policy policy)
+  : _policy(policy),
+    _time(0.0),
+    _nextPos(0) {}
+
+void Scheduler::setPolicy(Policy policy) {
+  _policy = policy;
+  _pass.clear();
+  _passPos.clear();
+  _nextPos = 0;
+}
+
+unsigned int Scheduler::next(unsigned int numParticles) {
+  Q_ASSERT(numParticles > 0);
+
+  if (!usesPasses()) {
+    return randInt(0, numParticles);
+  }
+
+  // Skip the entries of removed particles, starting a new pass when the
+  // current one is exhausted. A new pass has no removed entries.
+  while (_nextPos < _pass.size() && _pass[_nextPos] == none) {
+    ++_nextPos;
+  }
+  if (_nextPos == _pass.size()) {
+    beginPass(numParticles);
+  }
+  const unsigned int index = _pass[_nextPos++];
+  _passPos[index] = none;
+  return index;
+}
+
+void Scheduler::particleRemoved(unsigned int index, unsigned int lastIndex) {
+  Q_ASSERT(index <= lastIndex);
+
+  if (!usesPasses()) {
+    return;
+  }
+
+  // Particles inserted after the pass started have no entry in _passPos.
+  if (index < _passPos.size() && _passPos[index] != none) {
+    _pass[_passPos[index]] = none;
+    _passPos[index] = none;
+  }
+  if (lastIndex < _passPos.size()) {
+    if (lastIndex != index && _passPos[lastIndex] != none) {
+      _pass[_passPos[lastIndex]] = index;
+      _passPos[index] = _passPos[lastIndex];
+    }
+    _passPos.pop_back();
+  }
+}
+
+void Scheduler::advanceTime(unsigned int numClocks) {
+  Q_ASSERT(numClocks > 0);
+
+  if (_policy != Policy::Poisson) {
+    return;
+  }
+  _time -= std::log1p(-randDouble(0.0, 1.0)) / numClocks;
+}
+
+std::size_t Scheduler::memoryUsage() const {
+  return (_pass.capacity() + _passPos.capacity()) * sizeof(unsigned int);
+}
+
+void Scheduler::setDefaultPolicy(Policy policy) {
+  defaultPolicyKind = static_cast<int>(policy);
+}
+
+Scheduler::Policy Scheduler::defaultPolicy() {
+  return static_cast<Policy>(defaultPolicyKind.load());
+}
+
+QString Scheduler::policyName(Policy policy) {
+  switch (policy) {
+    case Policy::Permutation:
+      return "permutation";
+    case Policy::Sweep:
+      return "sweep";
+    case Policy::Poisson:
+      return "poisson";
+    default:
+      return "uniform";
+  }
+}
+
+Scheduler::Policy Scheduler::policyFromName(const QString& name) {
+  if (name == "permutation") {
+    return Policy::Permutation;
+  } else if (name == "sweep") {
+    return Policy::Sweep;
+  } else if (name == "poisson") {
+    return Policy::Poisson;
+  }
+  return Policy::Uniform;
+}
+
+bool Scheduler::isPolicyName(const QString& name) {
+  return policyName(policyFromName(name)) == name;
+}
+
+void Scheduler::setNextPolicy(Policy policy) {
+  _nextPolicy = policy;
+  _hasNextPolicy = true;
+}
+
+Scheduler::Policy Scheduler::takeNextPolicy() {
+  if (_hasNextPolicy) {
+    _hasNextPolicy = false;
+    return _nextPolicy;
+  }
+  return defaultPolicy();
+}
+
+void Scheduler::beginPass(unsigned int numParticles) {
+  _pass.resize(numParticles);
+  _passPos.resize(numParticles);
+  for (unsigned int i = 0; i < numParticles; ++i) {
+    _pass[i] = i;
+  }
+  if (_policy == Policy::Permutation) {
+    shuffle(_pass.begin(), _pass.end());
+  }
+  for (unsigned int pos = 0; pos < numParticles; ++pos) {
+    _passPos[_pass[pos]] = pos;
+  }
+  _nextPos = 0;
+}
@@ -0,0 +1,131 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the policy an AmoebotSystem uses to choose which particle activate
+// runs next. The policy is chosen when the system is constructed and can be
+// changed later:
+//
+//   Uniform      picks a particle uniformly at random with replacement, as in
+//                the standard sequential asynchronous model. A round takes
+//                about n ln n activations.
+//   Permutation  activates the particles in a random order, reshuffled at the
+//                start of every pass, so that each particle is activated
+//                exactly once per pass of n activations.
+//   Sweep        activates the particles in the order of the system's particle
+//                list, one pass after another.
+//   Poisson      gives every particle an independent Poisson clock of rate 1
+//                and activates particles as their clocks ring. The order of
+//                activations is the same as for Uniform, but the system also
+//                tracks the continuous time that has passed (see time()).
+//
+// The scheduler works on indices into the system's particle list, so it never
+// touches particles itself. A pass over the particles is fixed when it starts:
+// particles inserted during a pass join the next one, and the system reports
+// every removal so that removed particles are skipped and the particle moved
+// into the vacated slot keeps its place in the pass.
+
+#ifndef AMOEBOTSIM_CORE_SCHEDULER_H_
+#define AMOEBOTSIM_CORE_SCHEDULER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <QString>
+
+#include "helper/randomnumbergenerator.h"
+
+class Scheduler : public RandomNumberGenerator {
+ public:
+  enum class Policy {
+    Uniform,      // Uniformly random with replacement.
+    Permutation,  // Random permutation per pass.
+    Sweep,        // Particle list order per pass.
+    Poisson       // Rate-1 Poisson clock per particle, in continuous time.
+  };
+
+  // Constructs a scheduler using the given policy, at time 0.
+  explicit Scheduler(Policy policy = Policy::Uniform);
+
+  // Returns or changes the policy. Changing the policy abandons the current
+  // pass.
+  Policy policy() const;
+  void setPolicy(Policy policy);
+
+  // Returns true if and only if the policy activates the particles in passes
+  // (Permutation and Sweep) rather than drawing each activation independently.
+  bool usesPasses() const;
+
+  // Returns the index of the particle to activate next among the given number
+  // of particles, which must be positive. Draws from the random stream bound to
+  // the calling thread.
+  unsigned int next(unsigned int numParticles);
+
+  // Informs the scheduler that the particle at the given index is being
+  // removed and that the particle at lastIndex, the last one in the particle
+  // list, moves into its slot.
+  void particleRemoved(unsigned int index, unsigned int lastIndex);
+
+  // Returns the continuous time that has passed under the Poisson policy (0
+  // for the other policies). Under the Poisson policy, advanceTime advances it
+  // by the time until the first of the given number of rate-1 Poisson clocks
+  // rings, which is exponentially distributed with rate numClocks; under the
+  // other policies it does nothing.
+  double time() const;
+  void advanceTime(unsigned int numClocks);
+
+  // Returns the number of bytes allocated for the current pass.
+  std::size_t memoryUsage() const;
+
+  // Sets or returns the policy of the schedulers of systems constructed without
+  // a policy set by setNextPolicy, and converts between policies and their
+  // names ("uniform", "permutation", "sweep", or "poisson"). Unknown names map
+  // to the uniform policy.
+  static void setDefaultPolicy(Policy policy);
+  static Policy defaultPolicy();
+  static QString policyName(Policy policy);
+  static Policy policyFromName(const QString& name);
+  static bool isPolicyName(const QString& name);
+
+  // Sets the policy of the next system constructed on the calling thread.
+  // takeNextPolicy returns and clears that policy, or returns the default
+  // policy if none was set.
+  static void setNextPolicy(Policy policy);
+  static Policy takeNextPolicy();
+
+ private:
+  // Starts a new pass over the given number of particles.
+  void beginPass(unsigned int numParticles);
+
+  // Marks an entry of the pass (or of _passPos) that no longer refers to a
+  // particle.
+  static const unsigned int none = 0xffffffffu;
+
+  Policy _policy;
+  double _time;
+
+  // The current pass: _pass holds particle indices in activation order (none
+  // for removed particles), _passPos[i] holds the position of particle i in
+  // _pass (none if it is not part of the pass), and _nextPos is the position
+  // of the next entry to activate.
+  std::vector<unsigned int> _pass;
+  std::vector<unsigned int> _passPos;
+  unsigned int _nextPos;
+
+  static thread_local bool _hasNextPolicy;
+  static thread_local Policy _nextPolicy;
+};
+
+inline Scheduler::Policy Scheduler::policy() const {
+  return _policy;
+}
+
+inline bool Scheduler::usesPasses() const {
+  return _policy == Policy::Permutation || _policy == Policy::Sweep;
+}
+
+inline double Scheduler::time() const {
+  return _time;
+}
+
+#endif  // AMOEBOTSIM_CORE_SCHEDULER_H_
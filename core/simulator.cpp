@@ -4,6 +4,8 @@
 
 #include "core/simulator.h"
 
+#include <utility>
+
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
@@ -13,22 +15,79 @@
 #include <QtGlobal>
 
 #include "core/metric.h"
+#include "core/rendersnapshot.h"
+
+namespace {
+
+// The minimum time in milliseconds between two progressed signals of a running
+// simulation, i.e., one frame at 60 frames per second.
+constexpr qint64 frameDuration = 1000 / 60;
+
+// The number of activations between two checks of the clock in a time-sliced
+// tick; reading the clock after every activation would take a noticeable
+// share of the time of cheap activations.
+constexpr unsigned int activationsPerClockCheck = 16;
+
+}  // namespace
 
-Simulator::Simulator() {
+Simulator::Simulator()
+  : stepTimer(this),
+    terminationCheckInterval(1),
+    batchSize(0),
+    timeSlice(10),
+    lockWaitNsecs(0),
+    snapshotOutdated(true),
+    densitySnapshots(false) {
   stepTimer.setInterval(100);
-  connect(&stepTimer, &QTimer::timeout, this, &Simulator::step);
+  connect(&stepTimer, &QTimer::timeout, this, &Simulator::tick);
+  progressClock.start();
 }
 
 Simulator::~Simulator() {
+  if (workerThread.isRunning()) {
+    // Timers must be stopped by the thread they live in, so stop the timer on
+    // the worker thread and hand the simulator back before the thread quits.
+    QThread* owner = QThread::currentThread();
+    forwardToOwnThread([this, owner]() {
+      stepTimer.stop();
+      moveToThread(owner);
+    });
+    workerThread.quit();
+    workerThread.wait();
+  }
   stepTimer.stop();
 }
 
+void Simulator::runOnWorkerThread() {
+  Q_ASSERT(!workerThread.isRunning());
+
+  // Signals carrying a system are queued across threads from now on.
+  qRegisterMetaType<std::shared_ptr<System>>("std::shared_ptr<System>");
+  workerThread.start();
+  moveToThread(&workerThread);
+}
+
 void Simulator::setSystem(std::shared_ptr<System> _system) {
+  std::shared_ptr<System> previous;
+  if (forwardToOwnThread([this, &_system, &previous]() {
+        previous = system;
+        setSystem(_system);
+      })) {
+    return;
+  }
+
   stepTimer.stop();
   emit stopped();
 
   system = _system;
+  lockWaitNsecs = 0;
+  if (system != nullptr) {
+    system->setTerminationCheckInterval(terminationCheckInterval);
+  }
   emit systemChanged(system);
+  if (system != nullptr) {
+    notifyProgress(true);
+  }
 }
 
 std::shared_ptr<System> Simulator::getSystem() const {
@@ -36,38 +95,162 @@ std::shared_ptr<System> Simulator::getSystem() const {
 }
 
 void Simulator::start() {
+  if (forwardToOwnThread([this]() { start(); })) {
+    return;
+  }
+
   stepTimer.start();
   emit started();
 }
 
 void Simulator::stop() {
+  if (forwardToOwnThread([this]() { stop(); })) {
+    return;
+  }
+
   stepTimer.stop();
   emit stopped();
+  notifyProgress(true);
 }
 
 void Simulator::step() {
+  if (forwardToOwnThread([this]() { step(); })) {
+    return;
+  }
+
   QMutexLocker locker(&system->mutex);
   system->activate();
+  const bool terminated =
+      system->isTerminationCheckDue() && system->hasTerminated();
+  locker.unlock();
 
-  if (system->hasTerminated()) {
+  if (terminated) {
     stop();
+  } else {
+    notifyProgress(true);
   }
 }
 
 void Simulator::stepForParticleAt(Node node) {
+  if (forwardToOwnThread([this, node]() { stepForParticleAt(node); })) {
+    return;
+  }
+
   QMutexLocker locker(&system->mutex);
   system->activateParticleAt(node);
+  locker.unlock();
+  notifyProgress(true);
 }
 
 void Simulator::setStepDuration(int ms) {
+  if (forwardToOwnThread([this, ms]() { setStepDuration(ms); })) {
+    return;
+  }
+
   stepTimer.setInterval(ms);
   emit stepDurationChanged(ms);
 }
 
 void Simulator::runUntilTermination() {
+  if (forwardToOwnThread([this]() { runUntilTermination(); })) {
+    return;
+  }
+
   QMutexLocker locker(&system->mutex);
-  while (!system->hasTerminated()) {
+  if (system->hasTerminated()) {
+    return;
+  }
+  do {
     system->activate();
+  } while (!(system->isTerminationCheckDue() && system->hasTerminated()));
+  locker.unlock();
+  notifyProgress(true);
+}
+
+void Simulator::setTerminationCheckInterval(int interval) {
+  if (forwardToOwnThread([this, interval]() {
+        setTerminationCheckInterval(interval);
+      })) {
+    return;
+  }
+
+  Q_ASSERT(interval >= 0);
+  terminationCheckInterval = static_cast<unsigned int>(interval);
+  if (system != nullptr) {
+    QMutexLocker locker(&system->mutex);
+    system->setTerminationCheckInterval(terminationCheckInterval);
+  }
+}
+
+void Simulator::setBatchSize(int numActivations) {
+  if (forwardToOwnThread([this, numActivations]() {
+        setBatchSize(numActivations);
+      })) {
+    return;
+  }
+
+  Q_ASSERT(numActivations >= 0);
+  batchSize = static_cast<unsigned int>(numActivations);
+}
+
+void Simulator::setTimeSlice(int ms) {
+  if (forwardToOwnThread([this, ms]() { setTimeSlice(ms); })) {
+    return;
+  }
+
+  Q_ASSERT(ms >= 0);
+  timeSlice = ms;
+}
+
+void Simulator::publishSnapshot(bool density) {
+  Q_ASSERT(QThread::currentThread() == thread());
+
+  if (densitySnapshots.exchange(density) != density) {
+    snapshotOutdated = true;
+  }
+  if (system == nullptr || !snapshotOutdated.exchange(false)) {
+    return;
+  }
+
+  std::unique_ptr<RenderSnapshot> snapshot = system->renderSnapshots.acquire();
+  QElapsedTimer waitClock;
+  waitClock.start();
+  QMutexLocker locker(&system->mutex);
+  lockWaitNsecs += waitClock.nsecsElapsed();
+  if (density) {
+    snapshot->captureDensity(*system);
+  } else {
+    snapshot->capture(*system);
+  }
+  locker.unlock();
+  system->renderSnapshots.publish(std::move(snapshot));
+}
+
+void Simulator::tick() {
+  const bool timeSliced = batchSize == 0 && stepTimer.interval() == 0;
+  const unsigned int numActivations = (batchSize == 0) ? 1 : batchSize;
+  QElapsedTimer sliceClock;
+  sliceClock.start();
+
+  QMutexLocker locker(&system->mutex);
+  lockWaitNsecs += sliceClock.nsecsElapsed();
+  sliceClock.restart();
+  bool terminated = false;
+  unsigned int i = 0;
+  do {
+    system->activate();
+    ++i;
+    terminated = system->isTerminationCheckDue() && system->hasTerminated();
+  } while (!terminated &&
+           (timeSliced ? (i % activationsPerClockCheck != 0 ||
+                          sliceClock.elapsed() < timeSlice)
+                       : i < numActivations));
+  locker.unlock();
+
+  if (terminated) {
+    stop();
+  } else {
+    notifyProgress(false);
   }
 }
 
@@ -97,6 +280,15 @@ QVariant Simulator::metrics() const {
   return QVariant::fromValue(metricsData);
 }
 
+QString Simulator::memoryReport() const {
+  QMutexLocker locker(&system->mutex);
+  return system->memoryAsJSON();
+}
+
+double Simulator::lockWaitTime() const {
+  return lockWaitNsecs / 1e6;
+}
+
 void Simulator::exportMetrics() {
   QMutexLocker locker(&system->mutex);
   QDir metricsDir(QCoreApplication::applicationDirPath());
@@ -118,6 +310,19 @@ void Simulator::exportMetrics() {
 }
 
 void Simulator::saveScreenshotSetup(const QString filePath) {
+  // Scripts call this from their own thread, but the snapshot must be captured
+  // on the simulator's thread.
+  if (!forwardToOwnThread([this]() { publishSnapshot(densitySnapshots); })) {
+    publishSnapshot(densitySnapshots);
+  }
   emit systemChanged(system);
   emit saveScreenshot(filePath);
 }
+
+void Simulator::notifyProgress(bool force) {
+  snapshotOutdated = true;
+  if (force || progressClock.elapsed() >= frameDuration) {
+    progressClock.restart();
+    emit progressed();
+  }
+}
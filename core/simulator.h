@@ -5,9 +5,13 @@
 #ifndef AMOEBOTSIM_CORE_SIMULATOR_H_
 #define AMOEBOTSIM_CORE_SIMULATOR_H_
 
+#include <atomic>
 #include <memory>
 
+#include <QElapsedTimer>
+#include <QMetaObject>
 #include <QObject>
+#include <QThread>
 #include <QTimer>
 #include <QVariant>
 
@@ -20,6 +24,16 @@ class Simulator : public QObject {
   Simulator();
   virtual ~Simulator();
 
+  // Moves the simulator to a worker thread of its own, on which all
+  // activations run from then on, so that running a system does not compete
+  // with the GUI's event loop. Must be called at most once, from the thread
+  // that created the simulator. Without it (e.g., in headless runs), the
+  // simulator runs on the thread that created it.
+  void runOnWorkerThread();
+
+  // Replaces the simulated system, stopping the current run. The previous
+  // system is released on the calling thread, which is usually the thread that
+  // created it.
   void setSystem(std::shared_ptr<System> _system);
   std::shared_ptr<System> getSystem() const;
 
@@ -31,23 +45,63 @@ class Simulator : public QObject {
   void started();
   void stopped();
 
+  // Notifies the GUI that the system has changed. While the simulator is
+  // running, this is emitted at most once per frame (at 60 frames per second),
+  // no matter how many activations ran in between; it is also emitted after
+  // every step, run, and stop.
+  void progressed();
+
  public slots:
   // Responds to control flow signals from the GUI and scripts. Start, stop, and
   // step are self-explanatory. stepForParticleAt executes one activation for
   // the specific particle at the given node. setStepDuration updates the delay
-  // in milliseconds between particle activations. runUntilTermination activates
-  // particles repeatedly until the hasTerminated condition is satisfied.
+  // in milliseconds between ticks, i.e., batches of activations (see
+  // setBatchSize). runUntilTermination activates particles repeatedly until the
+  // hasTerminated condition is satisfied. setTerminationCheckInterval sets how
+  // often hasTerminated is evaluated for this and all subsequent systems; see
+  // System::setTerminationCheckInterval. These functions are thread-safe: when
+  // called from another thread, they run on the simulator's thread and return
+  // once they are done there.
   void start();
   void stop();
   void step();
   void stepForParticleAt(Node node);
   void setStepDuration(int ms);
   void runUntilTermination();
+  void setTerminationCheckInterval(int interval);
+
+  // Sets how many activations a tick of a running simulation executes. With a
+  // batch size of k >= 1, every tick executes k activations. With batch size 0
+  // (the default), a tick executes a single activation if the step duration is
+  // positive, and otherwise activates particles without pause for the given
+  // time slice in milliseconds (10 by default). A tick ends early if the
+  // system terminates. Both functions are thread-safe like the ones above.
+  void setBatchSize(int numActivations);
+  void setTimeSlice(int ms);
+
+  // Captures a render snapshot of the system and publishes it to the renderer
+  // (see rendersnapshot.h), unless the system has not changed since the last
+  // snapshot of the same kind. The snapshot holds the system's densities if
+  // density is true and its particles otherwise. The renderer requests this
+  // once per frame, so the cost of capturing is bounded by the frame rate and
+  // headless runs never pay it. Unlike the slots above, this does not forward
+  // itself: it reads the system unsynchronized and must run on the simulator's
+  // thread. Other threads must invoke it through a queued connection, as the
+  // renderer's snapshotRequested signal does, rather than call it directly.
+  void publishSnapshot(bool density);
 
   // Responds to GUI and script requests for statistics and metrics.
+  // memoryReport returns the system's memory report as JSON.
   int numParticles() const;
   int numImmoParticles() const;
   QVariant metrics() const;
+  QString memoryReport() const;
+
+  // Returns the total time in milliseconds the simulator spent waiting for the
+  // system's mutex, held by another thread, while running the current system.
+  // Since the renderer draws from render snapshots, this only grows when GUI
+  // or script requests hold the mutex.
+  double lockWaitTime() const;
 
   // Responds to the exportMetrics signal from the GUI and scripts by creating
   // an output file with a unique timestamp (to avoid accidental overwrites) and
@@ -58,9 +112,42 @@ class Simulator : public QObject {
   // takes a screenshot of the result.
   void saveScreenshotSetup(const QString filePath);
 
+ private slots:
+  // Executes the activations of one tick of a running simulation; see
+  // setBatchSize.
+  void tick();
+
  protected:
+  QThread workerThread;
   QTimer stepTimer;
   std::shared_ptr<System> system;
+  unsigned int terminationCheckInterval;
+  unsigned int batchSize;
+  int timeSlice;
+  QElapsedTimer progressClock;
+  std::atomic<qint64> lockWaitNsecs;
+  std::atomic<bool> snapshotOutdated;
+  std::atomic<bool> densitySnapshots;
+
+ private:
+  // If the calling thread is not the simulator's thread, runs func on the
+  // simulator's thread, waits until it returns, and returns true. Otherwise,
+  // returns false without running func, and the caller proceeds by itself.
+  template<class Func>
+  bool forwardToOwnThread(Func func);
+
+  // Marks the render snapshot as outdated and emits progressed if a frame has
+  // passed since it was last emitted, or unconditionally if force is true.
+  void notifyProgress(bool force);
 };
 
+template<class Func>
+bool Simulator::forwardToOwnThread(Func func) {
+  if (QThread::currentThread() == thread()) {
+    return false;
+  }
+  QMetaObject::invokeMethod(this, func, Qt::BlockingQueuedConnection);
+  return true;
+}
+
 #endif  // AMOEBOTSIM_CORE_SIMULATOR_H_
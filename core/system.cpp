@@ -21,6 +21,11 @@ const SystemIterator& SystemIterator::operator++() {
   return *this;
 }
 
+System::System()
+  : _terminationCheckInterval(1),
+    _activationsSinceCheck(0),
+    _activationLimit(0) {}
+
 SystemIterator System::begin() const {
   return SystemIterator(this, 0);
 }
@@ -32,3 +37,30 @@ SystemIterator System::end() const {
 bool System::hasTerminated() const {
   return false;
 }
+
+void System::setTerminationCheckInterval(unsigned int interval) {
+  _terminationCheckInterval = interval;
+  _activationsSinceCheck = 0;
+}
+
+unsigned int System::terminationCheckInterval() const {
+  return _terminationCheckInterval;
+}
+
+bool System::isTerminationCheckDue() {
+  if (_terminationCheckInterval <= 1) {
+    return true;
+  } else if (++_activationsSinceCheck >= _terminationCheckInterval) {
+    _activationsSinceCheck = 0;
+    return true;
+  }
+  return false;
+}
+
+void System::setActivationLimit(unsigned long long limit) {
+  _activationLimit = limit;
+}
+
+unsigned long long System::activationLimit() const {
+  return _activationLimit;
+}
@@ -18,6 +18,8 @@
 #include "core/node.h"
 #include "core/immoparticle.h"
 #include "core/particle.h"
+#include "core/particlepositions.h"
+#include "core/rendersnapshot.h"
 
 // System is forward declared to avoid a cyclic dependency with SystemIterator.
 class System;
@@ -43,6 +45,10 @@ class SystemIterator {
 
 class System {
  public:
+  // Constructs a system whose termination is checked after every activation.
+  System();
+  virtual ~System() = default;
+
   // Signatures for functions which activate particles. Must be overridden by
   // any system subclasses; see amoebotsystem.h for more detailed documentation.
   virtual void activate() = 0;
@@ -62,6 +68,10 @@ class System {
   // Returns a reference to the immobilizde particles list.
   virtual const std::deque<ImmoParticle*>& getImmoParticles() const = 0;
 
+  // Returns the positions of the particles as contiguous arrays, indexed like
+  // at(); see particlepositions.h.
+  virtual const ParticlePositions& positions() const = 0;
+
   // STL-like begin and end functions for particle-accessing iterators.
   SystemIterator begin() const;
   SystemIterator end() const;
@@ -74,8 +84,30 @@ class System {
   virtual Measure& getMeasure(QString name) const = 0;
   virtual const QString metricsAsJSON() const = 0;
 
+  // Returns a JSON report of the memory held by the system; see amoebotsystem.h.
+  virtual const QString memoryAsJSON() const = 0;
+
   virtual bool hasTerminated() const;
 
+  // Controls how often drivers (the simulator and the trial runner) evaluate
+  // hasTerminated() while running this system: after every activation
+  // (interval 1, the default), after every interval-th activation, or, for
+  // interval 0, once per completed round. isTerminationCheckDue is called after
+  // each activation and returns whether hasTerminated() should be evaluated.
+  // Systems without rounds treat interval 0 like interval 1.
+  void setTerminationCheckInterval(unsigned int interval);
+  unsigned int terminationCheckInterval() const;
+  virtual bool isTerminationCheckDue();
+
+  // Caps how far a single activate() call may advance the activation count,
+  // for drivers that run a system under an activation budget. A call never
+  // takes the count past the limit unless the limit is already reached, in
+  // which case it still records a single activation. Only matters for systems
+  // that can record several activations per call; 0 (the default) disables
+  // the cap.
+  void setActivationLimit(unsigned long long limit);
+  unsigned long long activationLimit() const;
+
  protected:
   // Checks whether the particle system forms one connected component.
   template<class ParticleContainer>
@@ -83,6 +115,15 @@ class System {
 
  public:
   QMutex mutex;
+
+  // The snapshots the simulator publishes for the renderer, which draws from
+  // them instead of locking the mutex; see rendersnapshot.h.
+  RenderSnapshotBuffer renderSnapshots;
+
+ protected:
+  unsigned int _terminationCheckInterval;
+  unsigned int _activationsSinceCheck;
+  unsigned long long _activationLimit;
 };
 
 template<class ParticleContainer>
@@ -95,9 +136,13 @@ bool System::isConnected(const ParticleContainer& particles) {
     }
   }
 
+  if (occupiedNodes.empty()) {
+    return true;
+  }
+
   std::deque<Node> queue;
   queue.push_back(*occupiedNodes.begin());
-  occupiedNodes.clear(); // remove the first node already
+  occupiedNodes.erase(occupiedNodes.begin());  // Remove the first node already.
 
   while (!queue.empty()) {
     Node n = queue.front();
@@ -0,0 +1,31 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/tilegrid.h"
+
+constexpr int TileGrid::tileShift;
+constexpr int TileGrid::tileSide;
+constexpr int TileGrid::tileMask;
+constexpr uintptr_t TileGrid::emptyCell;
+constexpr uintptr_t TileGrid::objectTag;
+
+TileGrid::Tile::Tile(const Node& origin)
+  : origin(origin) {
+  cells.fill(emptyCell);
+}
+
+void TileGrid::clear() {
+  _index.clear();
+  _tiles.clear();
+}
+
+unsigned int TileGrid::numTiles() const {
+  return _tiles.size();
+}
+
+std::size_t TileGrid::memoryUsage() const {
+  return _index.memoryUsage() +
+         _tiles.capacity() * sizeof(std::unique_ptr<Tile>) +
+         _tiles.size() * sizeof(Tile);
+}
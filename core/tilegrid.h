@@ -0,0 +1,120 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines an unbounded grid of lattice cells stored in fixed-size dense tiles.
+// Tiles are allocated lazily the first time one of their cells is written and
+// are addressed by a hash of their tile coordinates, so sparse and unbounded
+// systems still work. Each cell holds a single tagged word that is either empty,
+// a particle pointer, or an object pointer, so one load answers whether a node
+// is free regardless of what occupies it.
+
+#ifndef AMOEBOTSIM_CORE_TILEGRID_H_
+#define AMOEBOTSIM_CORE_TILEGRID_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "core/node.h"
+#include "core/nodehashmap.h"
+
+class TileGrid {
+ public:
+  // Tiles are 16x16 nodes (2 KiB on 64-bit platforms). Larger tiles waste too
+  // much memory on long, thin configurations such as the initial line used by
+  // compression, while smaller tiles make the tile lookup dominate.
+  static constexpr int tileShift = 4;
+  static constexpr int tileSide = 1 << tileShift;
+  static constexpr int tileMask = tileSide - 1;
+
+  // Values stored in cells. Cell values are pointers whose lowest bit tags the
+  // kind of occupant, which is safe since particles and objects are at least
+  // 2-byte aligned.
+  static constexpr uintptr_t emptyCell = 0;
+  static constexpr uintptr_t objectTag = 1;
+
+  // Returns the raw cell value at the given node (emptyCell if the node's tile
+  // has never been written).
+  uintptr_t cellAt(const Node& node) const;
+
+  // Writes the raw cell value at the given node, allocating its tile if needed.
+  void setCell(const Node& node, uintptr_t value);
+
+  // Removes all tiles.
+  void clear();
+
+  // Returns the number of allocated tiles.
+  unsigned int numTiles() const;
+
+  // Returns the number of bytes allocated for the tiles and their index.
+  std::size_t memoryUsage() const;
+
+  // Calls func(node, value) for every non-empty cell in unspecified order.
+  template<class Func>
+  void forEachCell(Func func) const;
+
+ private:
+  struct Tile {
+    Tile(const Node& origin);
+
+    Node origin;
+    std::array<uintptr_t, tileSide * tileSide> cells;
+  };
+
+  // Returns the coordinates of the tile containing the given node and the
+  // index of the node's cell within that tile.
+  static Node tileOf(const Node& node);
+  static int cellIndexOf(const Node& node);
+
+  NodeHashMap<Tile> _index;
+  std::vector<std::unique_ptr<Tile>> _tiles;
+};
+
+inline uintptr_t TileGrid::cellAt(const Node& node) const {
+  const Tile* tile = _index.find(tileOf(node));
+  return (tile == nullptr) ? emptyCell : tile->cells[cellIndexOf(node)];
+}
+
+inline void TileGrid::setCell(const Node& node, uintptr_t value) {
+  const Node tileNode = tileOf(node);
+  Tile* tile = _index.find(tileNode);
+  if (tile == nullptr) {
+    if (value == emptyCell) {
+      return;  // Nothing to clear in a tile that was never allocated.
+    }
+    _tiles.push_back(std::unique_ptr<Tile>(new Tile(tileNode)));
+    tile = _tiles.back().get();
+    _index.set(tileNode, tile);
+  }
+  tile->cells[cellIndexOf(node)] = value;
+}
+
+template<class Func>
+void TileGrid::forEachCell(Func func) const {
+  for (const auto& tile : _tiles) {
+    for (int i = 0; i < tileSide * tileSide; ++i) {
+      if (tile->cells[i] != emptyCell) {
+        func(Node(tile->origin.x * tileSide + (i & tileMask),
+                  tile->origin.y * tileSide + (i >> tileShift)),
+             tile->cells[i]);
+      }
+    }
+  }
+}
+
+inline Node TileGrid::tileOf(const Node& node) {
+  // Arithmetic shifts round toward negative infinity, so negative coordinates
+  // land in the correct tile.
+  return Node(node.x >> tileShift, node.y >> tileShift);
+}
+
+inline int TileGrid::cellIndexOf(const Node& node) {
+  return ((node.y & tileMask) << tileShift) | (node.x & tileMask);
+}
+
+#endif  // AMOEBOTSIM_CORE_TILEGRID_H_
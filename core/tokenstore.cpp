@@ -0,0 +1,173 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/tokenstore.h"
+
+#include <array>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace {
+
+// Pooled blocks come in multiples of 16 bytes up to 256 bytes; larger tokens
+// are allocated directly. Released blocks are kept in a singly linked free list
+// per size class and thread, and are freed when the thread exits. Tokens may
+// still be released during thread exit after the free lists are destroyed
+// (e.g., by other thread_local objects holding tokens); from then on, blocks of
+// that thread bypass the pool.
+constexpr std::size_t blockGranularity = 16;
+constexpr std::size_t numSizeClasses = 16;
+
+// Set once the calling thread's free lists are destroyed. Being trivially
+// destructible, it stays readable for the rest of the thread's exit.
+thread_local bool freeListsDestroyed = false;
+
+struct FreeLists {
+  FreeLists() { heads.fill(nullptr); }
+  ~FreeLists() {
+    freeListsDestroyed = true;
+    for (void* head : heads) {
+      while (head != nullptr) {
+        void* next = *static_cast<void**>(head);
+        ::operator delete(head);
+        head = next;
+      }
+    }
+  }
+
+  std::array<void*, numSizeClasses> heads;
+};
+
+thread_local FreeLists freeLists;
+
+std::mutex registryMutex;
+std::unordered_map<std::type_index, int> registry;
+
+}  // namespace
+
+TokenStore::Token::Token()
+  : _typeId(-1) {}
+
+TokenStore::Token::~Token() {}
+
+TokenStore::TokenStore() {}
+
+TokenStore::TokenStore(const TokenStore& other)
+  : _contents(other._contents == nullptr
+              ? nullptr : new Contents(*other._contents)) {}
+
+TokenStore& TokenStore::operator=(const TokenStore& other) {
+  if (this != &other) {
+    _contents.reset(other._contents == nullptr
+                    ? nullptr : new Contents(*other._contents));
+  }
+  return *this;
+}
+
+void TokenStore::put(std::shared_ptr<Token> token) {
+  if (_contents == nullptr) {
+    _contents.reset(new Contents());
+  }
+
+  const unsigned int id = typeId(*token);
+  if (id >= _contents->queues.size()) {
+    _contents->queues.resize(id + 1);
+  }
+  _contents->queues[id].push(std::move(token), _contents->nextStamp++);
+  ++_contents->size;
+}
+
+unsigned int TokenStore::size() const {
+  return (_contents == nullptr) ? 0 : _contents->size;
+}
+
+std::size_t TokenStore::memoryUsage() const {
+  if (_contents == nullptr) {
+    return 0;
+  }
+
+  std::size_t bytes = sizeof(Contents) +
+                      _contents->queues.capacity() * sizeof(Queue);
+  for (const Queue& queue : _contents->queues) {
+    bytes += queue.memoryUsage();
+  }
+  return bytes;
+}
+
+void TokenStore::Queue::push(std::shared_ptr<Token> token, uint64_t stamp) {
+  _entries.push_back(Entry{std::move(token), stamp});
+}
+
+std::shared_ptr<TokenStore::Token> TokenStore::Queue::remove(unsigned int i) {
+  std::shared_ptr<Token> token;
+  if (i > 0) {
+    token = std::move(_entries[_head + i].token);
+    _entries.erase(_entries.begin() + _head + i);
+    return token;
+  }
+
+  token = std::move(_entries[_head++].token);
+  if (_head == _entries.size()) {
+    _entries.clear();
+    _head = 0;
+  } else if (2 * _head >= _entries.size()) {
+    _entries.erase(_entries.begin(), _entries.begin() + _head);
+    _head = 0;
+  }
+  return token;
+}
+
+std::size_t TokenStore::Queue::memoryUsage() const {
+  return _entries.capacity() * sizeof(Entry);
+}
+
+int TokenStore::typeId(const Token& token) {
+  // A token keeps its type id once looked up, so tokens that are passed from
+  // particle to particle only pay for the lookup once.
+  if (token._typeId < 0) {
+    token._typeId = registerType(typeid(token));
+  }
+  return token._typeId;
+}
+
+int TokenStore::registerType(const std::type_info& type) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  auto it = registry.find(std::type_index(type));
+  if (it == registry.end()) {
+    it = registry.emplace(std::type_index(type), registry.size()).first;
+  }
+  return it->second;
+}
+
+void* TokenStore::allocateBlock(std::size_t bytes) {
+  const std::size_t sizeClass = (bytes + blockGranularity - 1) /
+                                blockGranularity - 1;
+  if (sizeClass >= numSizeClasses) {
+    return ::operator new(bytes);
+  } else if (freeListsDestroyed) {
+    return ::operator new((sizeClass + 1) * blockGranularity);
+  }
+
+  void*& head = freeLists.heads[sizeClass];
+  if (head != nullptr) {
+    void* block = head;
+    head = *static_cast<void**>(block);
+    return block;
+  }
+  return ::operator new((sizeClass + 1) * blockGranularity);
+}
+
+void TokenStore::releaseBlock(void* block, std::size_t bytes) {
+  const std::size_t sizeClass = (bytes + blockGranularity - 1) /
+                                blockGranularity - 1;
+  if (sizeClass >= numSizeClasses || freeListsDestroyed) {
+    ::operator delete(block);
+    return;
+  }
+
+  void*& head = freeLists.heads[sizeClass];
+  *static_cast<void**>(block) = head;
+  head = block;
+}
@@ -0,0 +1,275 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the collection of tokens held by an AmoebotParticle. Tokens are kept
+// in one FIFO queue per concrete token type, and every token type is assigned a
+// small dense id the first time it is used, so queries for a token type go
+// straight to its queue instead of casting every token the particle holds.
+// Queries for a base token type (e.g., a type several token types derive from)
+// additionally visit the queues of the matching derived types, casting only the
+// first token of each non-empty queue. Every token is stamped with the order in
+// which it was put, so such queries still see the tokens of all matching types
+// in the order they were put, as if they were kept in a single queue.
+//
+// Most algorithms never use tokens, so an empty store is a single null pointer;
+// its queues are allocated by the first put(). Each queue is a vector with a
+// head index, so taking the first token of a queue takes amortized constant
+// time. Tokens are shared_ptrs so that they can be handed between particles. Tokens created with make() are
+// allocated from per-thread pools of fixed-size blocks that are reused once the
+// tokens are released.
+
+#ifndef AMOEBOTSIM_CORE_TOKENSTORE_H_
+#define AMOEBOTSIM_CORE_TOKENSTORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+class TokenStore {
+ public:
+  // The base of all tokens; see AmoebotParticle::Token.
+  struct Token {
+    Token();
+    virtual ~Token();
+
+   private:
+    friend class TokenStore;
+
+    // The dense id of this token's concrete type, or -1 if it has not been
+    // looked up yet.
+    mutable int _typeId;
+  };
+
+  // Constructs an empty store, which allocates no memory. Copies share the
+  // tokens of the original store, like copies of a container of shared_ptrs.
+  TokenStore();
+  TokenStore(const TokenStore& other);
+  TokenStore& operator=(const TokenStore& other);
+
+  // Appends the given token to the queue of its concrete type.
+  void put(std::shared_ptr<Token> token);
+
+  // Functions for finding tokens of type TokenType, i.e., tokens whose concrete
+  // type is TokenType or derives from it, in the order they were put. peek
+  // returns the first such token satisfying the given predicate (nullptr if
+  // there is none), and take additionally removes it. count returns the number
+  // of such tokens and has returns whether there is at least one; with a
+  // predicate accepting every token, it only looks at the first token of each
+  // queue, so it takes time linear in the number of token types held. The
+  // predicate is called with a const std::shared_ptr<Token>& that is known to
+  // point to a TokenType.
+  template<class TokenType, class Predicate>
+  std::shared_ptr<TokenType> peek(const Predicate& pred) const;
+  template<class TokenType, class Predicate>
+  std::shared_ptr<TokenType> take(const Predicate& pred);
+  template<class TokenType, class Predicate>
+  int count(const Predicate& pred) const;
+  template<class TokenType, class Predicate>
+  bool has(const Predicate& pred) const;
+
+  // Returns the total number of tokens in this store.
+  unsigned int size() const;
+
+  // Returns the number of bytes allocated for this store's queues (not counting
+  // the tokens themselves), which is 0 until the first put().
+  std::size_t memoryUsage() const;
+
+  // Creates a token of the given type from the pool of the calling thread.
+  template<class TokenType, class... Args>
+  static std::shared_ptr<TokenType> make(Args&&... args);
+
+  // A predicate accepting every token.
+  struct AnyToken {
+    bool operator()(const std::shared_ptr<Token>&) const { return true; }
+  };
+
+ private:
+  // A FIFO queue of tokens, each with the stamp it was put with. Taken tokens
+  // before the head are left as empty slots and compacted away once they make
+  // up half of the vector, so removing the first token takes amortized
+  // constant time; removing any other token shifts the tokens behind it.
+  class Queue {
+   public:
+    bool empty() const { return _head == _entries.size(); }
+    unsigned int size() const { return _entries.size() - _head; }
+    const std::shared_ptr<Token>& front() const {
+      return _entries[_head].token;
+    }
+    const std::shared_ptr<Token>& operator[](unsigned int i) const {
+      return _entries[_head + i].token;
+    }
+    uint64_t stamp(unsigned int i) const { return _entries[_head + i].stamp; }
+
+    void push(std::shared_ptr<Token> token, uint64_t stamp);
+    std::shared_ptr<Token> remove(unsigned int i);
+
+    // Returns the number of bytes allocated for this queue's entries.
+    std::size_t memoryUsage() const;
+
+   private:
+    struct Entry {
+      std::shared_ptr<Token> token;
+      uint64_t stamp;
+    };
+
+    std::vector<Entry> _entries;
+    unsigned int _head = 0;
+  };
+
+  // Allocator handing out pooled blocks; used by make().
+  template<class T>
+  struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template<class U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+      return static_cast<T*>(allocateBlock(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t n) {
+      releaseBlock(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template<class U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+  };
+
+  // Returns the dense id of the given token type, or of the given token's
+  // concrete type, respectively.
+  template<class TokenType>
+  static int typeId();
+  static int typeId(const Token& token);
+  static int registerType(const std::type_info& type);
+
+  // Allocates (resp., releases) a block of at least the given number of bytes
+  // from (resp., to) the calling thread's pool.
+  static void* allocateBlock(std::size_t bytes);
+  static void releaseBlock(void* block, std::size_t bytes);
+
+  // Returns true if the given queue is non-empty and holds tokens of type
+  // TokenType.
+  template<class TokenType>
+  static bool holds(const Queue& queue);
+
+  // Finds the first token of type TokenType satisfying pred, in the order they
+  // were put. Returns true and sets the position of the token if there is one.
+  template<class TokenType, class Predicate>
+  bool find(const Predicate& pred, int& queueId, int& index) const;
+
+  struct Contents {
+    std::vector<Queue> queues;
+    unsigned int size = 0;
+    uint64_t nextStamp = 0;
+  };
+
+  std::unique_ptr<Contents> _contents;
+};
+
+template<class TokenType, class Predicate>
+std::shared_ptr<TokenType> TokenStore::peek(const Predicate& pred) const {
+  int queueId, index;
+  if (find<TokenType>(pred, queueId, index)) {
+    return std::static_pointer_cast<TokenType>(
+        _contents->queues[queueId][index]);
+  }
+  return nullptr;
+}
+
+template<class TokenType, class Predicate>
+std::shared_ptr<TokenType> TokenStore::take(const Predicate& pred) {
+  int queueId, index;
+  if (!find<TokenType>(pred, queueId, index)) {
+    return nullptr;
+  }
+
+  std::shared_ptr<TokenType> token = std::static_pointer_cast<TokenType>(
+      _contents->queues[queueId].remove(index));
+  --_contents->size;
+  return token;
+}
+
+template<class TokenType, class Predicate>
+int TokenStore::count(const Predicate& pred) const {
+  int numTokens = 0;
+  if (_contents == nullptr) {
+    return 0;
+  }
+  for (const Queue& queue : _contents->queues) {
+    if (holds<TokenType>(queue)) {
+      for (unsigned int i = 0; i < queue.size(); ++i) {
+        numTokens += pred(queue[i]) ? 1 : 0;
+      }
+    }
+  }
+  return numTokens;
+}
+
+template<class TokenType, class Predicate>
+bool TokenStore::has(const Predicate& pred) const {
+  int queueId, index;
+  return find<TokenType>(pred, queueId, index);
+}
+
+template<class TokenType, class... Args>
+std::shared_ptr<TokenType> TokenStore::make(Args&&... args) {
+  return std::allocate_shared<TokenType>(PoolAllocator<TokenType>(),
+                                         std::forward<Args>(args)...);
+}
+
+template<class TokenType>
+int TokenStore::typeId() {
+  static const int id = registerType(typeid(TokenType));
+  return id;
+}
+
+template<class TokenType>
+bool TokenStore::holds(const Queue& queue) {
+  return !queue.empty() &&
+         dynamic_cast<const TokenType*>(queue.front().get()) != nullptr;
+}
+
+template<class TokenType, class Predicate>
+bool TokenStore::find(const Predicate& pred, int& queueId, int& index) const {
+  if (_contents == nullptr || _contents->size == 0) {
+    return false;
+  }
+
+  // Each queue is in the order its tokens were put, so only the first match in
+  // each queue holding TokenType is a candidate, and the search of a queue can
+  // stop at tokens put after the earliest candidate found so far. Tokens of the
+  // exact type need no cast.
+  const std::vector<Queue>& queues = _contents->queues;
+  const int exactId = typeId<TokenType>();
+  bool found = false;
+  uint64_t foundStamp = 0;
+  for (unsigned int id = 0; id < queues.size(); ++id) {
+    const Queue& queue = queues[id];
+    if (queue.empty() ||
+        (static_cast<int>(id) != exactId && !holds<TokenType>(queue))) {
+      continue;
+    }
+    for (unsigned int i = 0; i < queue.size(); ++i) {
+      if (found && queue.stamp(i) > foundStamp) {
+        break;
+      } else if (pred(queue[i])) {
+        found = true;
+        foundStamp = queue.stamp(i);
+        queueId = id;
+        index = i;
+        break;
+      }
+    }
+  }
+
+  return found;
+}
+
+#endif  // AMOEBOTSIM_CORE_TOKENSTORE_H_
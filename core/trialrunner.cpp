@@ -0,0 +1,100 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/trialrunner.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include "core/metric.h"
+
+namespace {
+
+// Runs one trial and stores its metrics JSON in its own slot of the result
+// list; distinct trials never write to the same slot, so no locking is needed.
+class TrialTask : public QRunnable {
+ public:
+  TrialTask(const TrialRunner::SystemFactory& factory, int trial,
+            const TrialRunner::Budget& budget, QString& result)
+    : _factory(factory),
+      _trial(trial),
+      _budget(budget),
+      _result(result) {}
+
+  void run() override {
+    std::shared_ptr<System> system = _factory(_trial);
+    if (system == nullptr) {
+      _result = "null";
+      return;
+    }
+    QMutexLocker locker(&system->mutex);
+    TrialRunner::runTrial(*system, _budget);
+    _result = system->metricsAsJSON();
+  }
+
+ private:
+  const TrialRunner::SystemFactory& _factory;
+  const int _trial;
+  const TrialRunner::Budget _budget;
+  QString& _result;
+};
+
+}  // namespace
+
+TrialRunner::TrialRunner(int numThreads)
+  : _numThreads(numThreads > 0 ? numThreads : QThread::idealThreadCount()) {}
+
+QString TrialRunner::run(const SystemFactory& factory, int numTrials,
+                         const Budget& budget) {
+  std::vector<QString> results(numTrials);
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(_numThreads);
+  for (int trial = 0; trial < numTrials; ++trial) {
+    pool.start(new TrialTask(factory, trial, budget, results[trial]));
+  }
+  pool.waitForDone();
+
+  QString json = "{\"title\" : \"AmoebotSim Trials JSON\", ";
+  json += "\"datetime\" : \"" +
+          QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
+  json += "\"trials\" : " + QString::number(numTrials) + ", ";
+  json += "\"results\" : [";
+  for (const auto& result : results) {
+    json += result + ", ";
+  }
+  if (!results.empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "]}";
+  return json;
+}
+
+int TrialRunner::numThreads() const {
+  return _numThreads;
+}
+
+unsigned long long TrialRunner::runTrial(System& system, const Budget& budget) {
+  // Look up the activation and round counts once; their values are read on
+  // every activation. The budget is checked against the activation count rather
+  // than the calls to activate, since a single call may record many skipped
+  // activations of quiescent particles; the activation limit keeps such a call
+  // from overshooting the budget.
+  const Count& activations = system.getCount("# Activations");
+  const Count& rounds = system.getCount("# Rounds");
+  system.setTerminationCheckInterval(budget.terminationCheckInterval);
+  system.setActivationLimit(budget.maxActivations);
+  bool terminated = system.hasTerminated();
+  while (!terminated &&
+         (budget.maxActivations == 0 ||
+          activations._value < budget.maxActivations) &&
+         (budget.maxRounds == 0 || rounds._value < budget.maxRounds)) {
+    system.activate();
+    terminated = system.isTerminationCheckDue() && system.hasTerminated();
+  }
+  return activations._value;
+}
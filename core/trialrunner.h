@@ -0,0 +1,63 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a runner for independent Monte Carlo trials of an algorithm. Each
+// trial builds its own system through a factory and runs it on a worker thread
+// of a private thread pool, so trials share no simulation state; the metrics of
+// all trials are collected into one JSON document.
+
+#ifndef AMOEBOTSIM_CORE_TRIALRUNNER_H_
+#define AMOEBOTSIM_CORE_TRIALRUNNER_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "core/system.h"
+
+class TrialRunner {
+ public:
+  // Creates the system for the trial with the given index. The factory is
+  // called on the worker thread that runs the trial and may be called from
+  // several threads at once. Returning nullptr marks the trial as failed.
+  using SystemFactory = std::function<std::shared_ptr<System>(int trial)>;
+
+  // Limits on the length of a trial. A trial stops as soon as its system's
+  // hasTerminated() returns true or any nonzero limit is reached; with both
+  // limits at 0, a trial runs until termination.
+  struct Budget {
+    Budget() : maxActivations(0), maxRounds(0), terminationCheckInterval(1) {}
+
+    unsigned long long maxActivations;
+    unsigned long long maxRounds;
+
+    // How often hasTerminated is evaluated; see
+    // System::setTerminationCheckInterval.
+    unsigned int terminationCheckInterval;
+  };
+
+  // Constructs a runner using the given number of worker threads, or one thread
+  // per core if numThreads <= 0.
+  explicit TrialRunner(int numThreads = 0);
+
+  // Runs numTrials independent trials and blocks until all of them finish.
+  // Returns a JSON document holding the number of trials and, in trial order,
+  // each trial's metrics JSON (null for trials whose factory failed).
+  QString run(const SystemFactory& factory, int numTrials,
+              const Budget& budget = Budget());
+
+  // Returns the number of worker threads this runner uses.
+  int numThreads() const;
+
+  // Runs a single system under the given budget on the calling thread and
+  // returns the system's activation count ("# Activations") afterwards.
+  static unsigned long long runTrial(System& system, const Budget& budget);
+
+ private:
+  const int _numThreads;
+};
+
+#endif  // AMOEBOTSIM_CORE_TRIALRUNNER_H_
@@ -0,0 +1,174 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines statically typed versions of AmoebotParticle and AmoebotSystem for
+// algorithms whose systems contain particles of a single type:
+//
+//   class FooParticle : public AmoebotParticleT<FooParticle> { ... };
+//   class FooSystem : public AmoebotSystemT<FooParticle> { ... };
+//
+// An AmoebotSystemT<ParticleT> only accepts particles of type ParticleT, and an
+// AmoebotParticleT<Derived> can only be constructed in an
+// AmoebotSystemT<Derived>. Every neighbor of such a particle is therefore
+// another Derived, so nbrAtLabel is a static_cast instead of a dynamic_cast and
+// labelOfFirstNbrWithProperty takes any callable, which the compiler can
+// inline, instead of a std::function. Systems mixing particle types keep using
+// AmoebotParticle and AmoebotSystem directly.
+
+#ifndef AMOEBOTSIM_CORE_TYPEDAMOEBOT_H_
+#define AMOEBOTSIM_CORE_TYPEDAMOEBOT_H_
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "core/amoebotparticle.h"
+#include "core/amoebotsystem.h"
+
+template<class ParticleT>
+class AmoebotSystemT;
+
+template<class Derived>
+class AmoebotParticleT : public AmoebotParticle {
+ public:
+  // Constructs a new particle as in AmoebotParticle, which must belong to a
+  // system of Derived particles.
+  AmoebotParticleT(const Node& head, int globalTailDir, const int orientation,
+                   AmoebotSystemT<Derived>& system);
+
+ protected:
+  // Gets a reference to the neighboring particle incident to the specified port
+  // label. Crashes if no such particle exists at this label; consider using
+  // hasNbrAtLabel() first if unsure. The polymorphic nbrAtLabel<ParticleType>
+  // remains available.
+  Derived& nbrAtLabel(int label) const;
+  using AmoebotParticle::nbrAtLabel;
+
+  // Returns the label of the first port incident to a neighboring particle
+  // that satisfies the specified property, starting at the (optionally)
+  // specified label and continuing counter-clockwise. propertyCheck is any
+  // callable taking a const ParticleType&; the explicit ParticleType argument
+  // is accepted for compatibility with AmoebotParticle but defaults to Derived.
+  template<class ParticleType = Derived, class Predicate>
+  int labelOfFirstNbrWithProperty(const Predicate& propertyCheck,
+                                  int startLabel = 0,
+                                  bool ignoreErrorParticles = true) const;
+};
+
+template<class ParticleT>
+class AmoebotSystemT : public AmoebotSystem {
+ public:
+  // Constructs an empty system; see AmoebotSystem.
+  explicit AmoebotSystemT(OccupancyIndex::Backend backend =
+                              OccupancyIndex::Backend::Tiled);
+
+  // Inserts a particle or an object, respectively, into the system; see
+  // AmoebotSystem::insert. Only particles of type ParticleT can be inserted.
+  void insert(ParticleT* particle);
+  void insert(ImmoParticle* object);
+  void insert(const std::vector<ParticleT*>& newParticles);
+
+  // Constructs a particle or an object of type T in the system's arena and
+  // inserts it; see AmoebotSystem::emplace. Hides the untyped emplace, so only
+  // particles of type ParticleT (or subclasses) and ImmoParticles can be
+  // emplaced; any other type fails to compile.
+  template<class T, class... Args>
+  T& emplace(Args&&... args);
+
+  // Returns the particle at the specified index of particles.
+  ParticleT& particleAt(int i) const;
+
+  // Calls func(particle) for every particle in the system, in the order of
+  // particles.
+  template<class Func>
+  void forEachParticle(Func func) const;
+};
+
+template<class Derived>
+AmoebotParticleT<Derived>::AmoebotParticleT(const Node& head,
+                                            int globalTailDir,
+                                            const int orientation,
+                                            AmoebotSystemT<Derived>& system)
+  : AmoebotParticle(head, globalTailDir, orientation, system) {}
+
+template<class Derived>
+inline Derived& AmoebotParticleT<Derived>::nbrAtLabel(int label) const {
+  AmoebotParticle* nbr = nbrParticleAtLabel(label);
+  Q_ASSERT(nbr != nullptr && dynamic_cast<Derived*>(nbr) != nullptr);
+
+  return static_cast<Derived&>(*nbr);
+}
+
+template<class Derived>
+template<class ParticleType, class Predicate>
+int AmoebotParticleT<Derived>::labelOfFirstNbrWithProperty(
+    const Predicate& propertyCheck, int startLabel,
+    bool ignoreErrorParticles) const {
+  const int labelLimit = isContracted() ? 6 : 10;
+
+  for (int labelOffset = 0; labelOffset < labelLimit; labelOffset++) {
+    const int label = (labelLimit + startLabel + labelOffset) % labelLimit;
+    const AmoebotParticle* nbr = nbrParticleAtLabel(label);
+    if (nbr != nullptr) {
+      const ParticleType& particle =
+          static_cast<const ParticleType&>(static_cast<const Derived&>(*nbr));
+      if (!ignoreErrorParticles && particle.isErrorParticle()) {
+        return -1;
+      } else if (propertyCheck(particle)) {
+        return label;
+      }
+    }
+  }
+
+  return -1;
+}
+
+template<class ParticleT>
+AmoebotSystemT<ParticleT>::AmoebotSystemT(OccupancyIndex::Backend backend)
+  : AmoebotSystem(backend) {}
+
+template<class ParticleT>
+void AmoebotSystemT<ParticleT>::insert(ParticleT* particle) {
+  AmoebotSystem::insert(particle);
+}
+
+template<class ParticleT>
+void AmoebotSystemT<ParticleT>::insert(ImmoParticle* object) {
+  AmoebotSystem::insert(object);
+}
+
+template<class ParticleT>
+void AmoebotSystemT<ParticleT>::insert(
+    const std::vector<ParticleT*>& newParticles) {
+  particles.reserve(particles.size() + newParticles.size());
+  for (auto p : newParticles) {
+    AmoebotSystem::insert(p);
+  }
+}
+
+template<class ParticleT>
+template<class T, class... Args>
+T& AmoebotSystemT<ParticleT>::emplace(Args&&... args) {
+  static_assert(std::is_base_of<ParticleT, T>::value ||
+                std::is_same<T, ImmoParticle>::value,
+                "AmoebotSystemT<ParticleT> only holds ParticleT particles");
+  return AmoebotSystem::emplace<T>(std::forward<Args>(args)...);
+}
+
+template<class ParticleT>
+inline ParticleT& AmoebotSystemT<ParticleT>::particleAt(int i) const {
+  return static_cast<ParticleT&>(*particles.at(i));
+}
+
+template<class ParticleT>
+template<class Func>
+void AmoebotSystemT<ParticleT>::forEachParticle(Func func) const {
+  for (auto p : particles) {
+    func(static_cast<ParticleT&>(*p));
+  }
+}
+
+#endif  // AMOEBOTSIM_CORE_TYPEDAMOEBOT_H_
@@ -0,0 +1,46 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the Philox4x32-10 counter-based random number generator (Salmon et
+// al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011). Philox is a
+// keyed bijection: it maps a 128-bit counter and a 64-bit key to 128 random
+// bits with no internal state, so any draw can be computed directly from the
+// (key, counter) pair that identifies it. Each block costs ten rounds of two
+// 32x32->64-bit multiplications and involves no branches or table lookups.
+
+#ifndef AMOEBOTSIM_HELPER_PHILOX_H_
+#define AMOEBOTSIM_HELPER_PHILOX_H_
+
+#include <array>
+#include <cstdint>
+
+namespace philox {
+
+using Counter = std::array<uint32_t, 4>;
+using Key = std::array<uint32_t, 2>;
+
+// Returns the four random words of the block at the given counter under the
+// given key.
+inline Counter philox4x32(Counter ctr, Key key) {
+  const uint32_t mul0 = 0xD2511F53u;
+  const uint32_t mul1 = 0xCD9E8D57u;
+  const uint32_t weyl0 = 0x9E3779B9u;
+  const uint32_t weyl1 = 0xBB67AE85u;
+
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t prod0 = static_cast<uint64_t>(mul0) * ctr[0];
+    const uint64_t prod1 = static_cast<uint64_t>(mul1) * ctr[2];
+    ctr = {{static_cast<uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0],
+            static_cast<uint32_t>(prod1),
+            static_cast<uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1],
+            static_cast<uint32_t>(prod0)}};
+    key[0] += weyl0;
+    key[1] += weyl1;
+  }
+  return ctr;
+}
+
+}  // namespace philox
+
+#endif  // AMOEBOTSIM_HELPER_PHILOX_H_
@@ -4,4 +4,104 @@
 
 #include "helper/randomnumbergenerator.h"
 
-std::mt19937 RandomNumberGenerator::rng;
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+const uint32_t RandomStream::constructionStream;
+const uint32_t RandomStream::schedulerStream;
+
+thread_local RandomStream* RandomStream::_current = nullptr;
+thread_local bool RandomStream::_hasNextSeed = false;
+thread_local uint64_t RandomStream::_nextSeed = 0;
+
+namespace {
+
+// One step of the SplitMix64 generator, a bijective mixer that turns nearby
+// inputs (e.g., consecutive trial indices) into unrelated outputs.
+uint64_t splitMix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// The engine used by streams constructed without an explicit engine.
+std::atomic<int> defaultEngineKind(
+    static_cast<int>(RandomStream::Engine::MersenneTwister));
+
+}  // namespace
+
+RandomStream::RandomStream(uint64_t seed, Engine engine)
+  : _engineKind(engine) {
+  this->seed(seed);
+}
+
+void RandomStream::seed(uint64_t seed) {
+  _seed = seed;
+  const uint64_t mixed = splitMix64(seed);
+  std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(mixed), static_cast<uint32_t>(mixed >> 32)};
+  _mt.seed(seq);
+
+  _key = {{static_cast<uint32_t>(mixed), static_cast<uint32_t>(mixed >> 32)}};
+  beginContext(constructionStream, 0);
+}
+
+void RandomStream::refill() {
+  _buffer = philox::philox4x32({{_block++, _streamId,
+                                 static_cast<uint32_t>(_counter),
+                                 static_cast<uint32_t>(_counter >> 32)}},
+                               _key);
+  _bufferPos = 0;
+}
+
+void RandomStream::setDefaultEngine(Engine engine) {
+  defaultEngineKind = static_cast<int>(engine);
+}
+
+RandomStream::Engine RandomStream::defaultEngine() {
+  return static_cast<Engine>(defaultEngineKind.load());
+}
+
+const char* RandomStream::engineName(Engine engine) {
+  return (engine == Engine::Philox) ? "philox" : "mt19937";
+}
+
+RandomStream::Engine RandomStream::engineFromName(const std::string& name) {
+  return (name == "philox") ? Engine::Philox : Engine::MersenneTwister;
+}
+
+uint64_t RandomStream::splitSeed(uint64_t seed, uint64_t index) {
+  return splitMix64(splitMix64(seed) ^ splitMix64(~index)) & ((1ull << 53) - 1);
+}
+
+uint64_t RandomStream::entropySeed() {
+  uint64_t seed;
+  std::random_device device;
+  if (device.entropy() == 0) {
+    // No real entropy source; fall back on the clock, mixing in the thread id
+    // so threads started at the same instant still get different seeds.
+    const auto duration = std::chrono::high_resolution_clock::now()
+                          .time_since_epoch();
+    seed = splitMix64(static_cast<uint64_t>(duration.count()) ^
+                      std::hash<std::thread::id>()(std::this_thread::get_id()));
+  } else {
+    seed = (static_cast<uint64_t>(device()) << 32) | device();
+  }
+  return seed & ((1ull << 53) - 1);
+}
+
+void RandomStream::setNextSeed(uint64_t seed) {
+  _nextSeed = seed;
+  _hasNextSeed = true;
+}
+
+uint64_t RandomStream::takeNextSeed() {
+  if (_hasNextSeed) {
+    _hasNextSeed = false;
+    return _nextSeed;
+  }
+  return entropySeed();
+}
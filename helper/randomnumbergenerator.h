@@ -2,18 +2,135 @@
  * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
  * notice can be found at the top of main/main.cpp. */
 
+// Defines seedable random number streams and the RandomNumberGenerator mixin
+// that particles and systems use to draw from them. Every AmoebotSystem owns a
+// RandomStream; while the system is being constructed or is activating a
+// particle, its stream is bound to the calling thread, and all draws made on
+// that thread (including those in particle constructors) come from it. Draws
+// made while no system is bound come from a per-thread default stream.
+//
+// A stream runs one of two engines. The Mersenne Twister engine is a single
+// sequential generator, so a run is only reproducible if activations happen in
+// exactly the same order. The Philox engine is counter-based (see philox.h):
+// the system opens a context for every activation, keyed by the particle's id
+// and its own activation count, and each draw is a pure function of (seed,
+// context, draw index). Which numbers a particle sees therefore does not depend
+// on how its activations interleave with other particles' activations.
+
 #ifndef AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
 #define AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
 
 #include <algorithm>
-#include <chrono>
+#include <cstdint>
 #include <random>
+#include <string>
+
+#include "helper/philox.h"
+
+class RandomStream {
+ public:
+  enum class Engine {
+    MersenneTwister,  // Sequential std::mt19937.
+    Philox            // Counter-based Philox4x32-10, keyed per activation.
+  };
+
+  // Stream ids of the contexts that are not tied to a particle: draws made
+  // while a system is being constructed, and the system's choice of which
+  // particle to activate next.
+  static const uint32_t constructionStream = 0xffffffffu;
+  static const uint32_t schedulerStream = 0xfffffffeu;
+
+  // Constructs a stream from the given seed using the given engine (by default,
+  // the process-wide default engine). Equal seeds yield equal streams.
+  explicit RandomStream(uint64_t seed, Engine engine = defaultEngine());
+
+  // Restarts this stream from the given seed.
+  void seed(uint64_t seed);
+
+  // Returns the seed this stream was (re)started from, and its engine.
+  uint64_t getSeed() const;
+  Engine getEngine() const;
+
+  // Opens the context in which the following draws are made. For the Philox
+  // engine, the k-th draw after this call depends only on the seed, streamId,
+  // counter, and k; for the Mersenne Twister engine this does nothing.
+  void beginContext(uint32_t streamId, uint64_t counter);
+
+  // UniformRandomBitGenerator interface, for use with standard distributions.
+  using result_type = uint32_t;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return 0xffffffffu; }
+  result_type operator()();
+
+  // Sets or returns the engine used by streams constructed without an explicit
+  // engine, and converts between engines and their names ("mt19937" or
+  // "philox"; unknown names map to mt19937).
+  static void setDefaultEngine(Engine engine);
+  static Engine defaultEngine();
+  static const char* engineName(Engine engine);
+  static Engine engineFromName(const std::string& name);
+
+  // Returns the seed of the index-th substream of the given base seed. The
+  // derived seeds are decorrelated with SplitMix64 and expanded to the full
+  // engine state with std::seed_seq, so substreams of one base seed (e.g., the
+  // trials of an experiment) are statistically independent.
+  static uint64_t splitSeed(uint64_t seed, uint64_t index);
+
+  // Returns a fresh seed from the system's entropy source. Seeds are kept below
+  // 2^53 so that they survive a round trip through JavaScript and JSON.
+  static uint64_t entropySeed();
+
+  // Sets the seed of the next stream created on the calling thread by
+  // takeNextSeed (i.e., of the next AmoebotSystem constructed on it).
+  // takeNextSeed returns and clears that seed, or returns an entropy seed if
+  // none was set.
+  static void setNextSeed(uint64_t seed);
+  static uint64_t takeNextSeed();
+
+  // Returns the stream bound to the calling thread, or the thread's default
+  // stream if none is bound.
+  static RandomStream& current();
+
+  // Binds the given stream to the calling thread, or unbinds the current one if
+  // stream is nullptr. bound returns the bound stream (or nullptr).
+  static void bind(RandomStream* stream);
+  static RandomStream* bound();
+
+  // Binds a stream to the calling thread for the lifetime of the scope object,
+  // restoring the previous binding afterwards.
+  class Scope {
+   public:
+    explicit Scope(RandomStream& stream);
+    ~Scope();
+
+   private:
+    RandomStream* const _previous;
+  };
+
+ private:
+  // Computes the next Philox block of the current context.
+  void refill();
+
+  uint64_t _seed;
+  Engine _engineKind;
+  std::mt19937 _mt;
+
+  // Philox state: the key (derived from the seed), the current context, the
+  // index of the next block within it, and the unread words of the last block.
+  philox::Key _key;
+  uint32_t _streamId;
+  uint64_t _counter;
+  uint32_t _block;
+  philox::Counter _buffer;
+  unsigned int _bufferPos;
+
+  static thread_local RandomStream* _current;
+  static thread_local bool _hasNextSeed;
+  static thread_local uint64_t _nextSeed;
+};
 
 class RandomNumberGenerator
 {
-public:
-    RandomNumberGenerator();
-
 protected:
     static int randInt(const int from, const int toNotIncluding);
     static int randDir();
@@ -23,34 +140,62 @@ protected:
 
     template <class Iterator>
     void shuffle(Iterator firxt, Iterator last);
-
-private:
-    static std::mt19937 rng;
 };
 
-inline RandomNumberGenerator::RandomNumberGenerator()
-{
-    static bool initialized = false;
-    if(!initialized) {
-        uint32_t seed;
-        std::random_device device;
-        if(device.entropy() == 0) {
-            auto duration = std::chrono::high_resolution_clock::now() - std::chrono::high_resolution_clock::time_point::min();
-            seed = duration.count();
-        } else {
-            std::uniform_int_distribution<uint32_t> dist(std::numeric_limits<uint32_t>::min(),
-                                                         std::numeric_limits<uint32_t>::max());
-            seed = dist(device);
-        }
-        rng.seed(seed);
-        initialized = true;
-    }
+inline uint64_t RandomStream::getSeed() const {
+  return _seed;
+}
+
+inline RandomStream::Engine RandomStream::getEngine() const {
+  return _engineKind;
+}
+
+inline void RandomStream::beginContext(uint32_t streamId, uint64_t counter) {
+  _streamId = streamId;
+  _counter = counter;
+  _block = 0;
+  _bufferPos = 4;
+}
+
+inline RandomStream::result_type RandomStream::operator()() {
+  if (_engineKind == Engine::MersenneTwister) {
+    return _mt();
+  }
+  if (_bufferPos == 4) {
+    refill();
+  }
+  return _buffer[_bufferPos++];
+}
+
+inline RandomStream& RandomStream::current() {
+  if (_current == nullptr) {
+    static thread_local RandomStream defaultStream(entropySeed());
+    return defaultStream;
+  }
+  return *_current;
+}
+
+inline void RandomStream::bind(RandomStream* stream) {
+  _current = stream;
+}
+
+inline RandomStream* RandomStream::bound() {
+  return _current;
+}
+
+inline RandomStream::Scope::Scope(RandomStream& stream)
+  : _previous(_current) {
+  _current = &stream;
+}
+
+inline RandomStream::Scope::~Scope() {
+  _current = _previous;
 }
 
 inline int RandomNumberGenerator::randInt(const int from, const int toNotIncluding)
 {
     std::uniform_int_distribution<int> dist(from, toNotIncluding - 1);
-    return dist(rng);
+    return dist(RandomStream::current());
 }
 
 inline int RandomNumberGenerator::randDir()
@@ -61,13 +206,13 @@ inline int RandomNumberGenerator::randDir()
 inline float RandomNumberGenerator::randFloat(const float from, const float toNotIncluding)
 {
     std::uniform_real_distribution<float> dist(from, toNotIncluding);
-    return dist(rng);
+    return dist(RandomStream::current());
 }
 
 inline double RandomNumberGenerator::randDouble(const double from, const double toNotIncluding)
 {
     std::uniform_real_distribution<double> dist(from, toNotIncluding);
-    return dist(rng);
+    return dist(RandomStream::current());
 }
 
 inline bool RandomNumberGenerator::randBool(const double trueProb)
@@ -78,7 +223,7 @@ inline bool RandomNumberGenerator::randBool(const double trueProb)
 template <class Iterator>
 void RandomNumberGenerator::shuffle(Iterator first, Iterator last)
 {
-    std::shuffle(first, last, rng);
+    std::shuffle(first, last, RandomStream::current());
 }
 
 #endif  // AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
@@ -24,7 +24,7 @@ Application::Application(int argc, char *argv[])
   auto qmlRoot = engine.rootObjects().first();
   auto vis = qmlRoot->findChild<VisItem*>();
   auto slider = qmlRoot->findChild<QObject*>("stepDurationSlider");
-  connect(vis, &VisItem::beforeRendering,
+  connect(&sim, &Simulator::progressed, qmlRoot,
           [this, qmlRoot](){
             QMetaObject::invokeMethod(qmlRoot, "setMetrics", Q_ARG(QVariant, sim.metrics()));
           }
@@ -52,7 +52,9 @@ Application::Application(int argc, char *argv[])
     connect(alg, &Algorithm::log, [qmlRoot](const QString msg, const bool isError){
       QMetaObject::invokeMethod(qmlRoot, "log", Q_ARG(QVariant, msg), Q_ARG(QVariant, isError));
     });
-    connect(alg, &Algorithm::setSystem, &sim, &Simulator::setSystem);
+    // Simulator::setSystem forwards itself to the simulator's thread and
+    // returns once the new system is in place, so call it directly.
+    connect(alg, &Algorithm::setSystem, &sim, &Simulator::setSystem, Qt::DirectConnection);
   }
 
   // setup connections between GUI and Simulator
@@ -72,7 +74,8 @@ Application::Application(int argc, char *argv[])
             QMetaObject::invokeMethod(qmlRoot, "setLabelStart");
           }
   );
-  connect(vis, &VisItem::stepForParticleAt, &sim, &Simulator::stepForParticleAt);
+  connect(vis, &VisItem::stepForParticleAt, &sim, &Simulator::stepForParticleAt, Qt::DirectConnection);
+  connect(vis, &VisItem::snapshotRequested, &sim, &Simulator::publishSnapshot);
   connect(slider, SIGNAL(stepDurationChanged(int)), &sim, SLOT(setStepDuration(int)));
   connect(&sim, &Simulator::stepDurationChanged,
           [slider](const int& ms){
@@ -92,4 +95,8 @@ Application::Application(int argc, char *argv[])
 
   // Set default step duration.
   sim.setStepDuration(0);
+
+  // Run activations on the simulator's own thread from now on, so that the
+  // event loop of this thread is left to the GUI.
+  sim.runOnWorkerThread();
 }
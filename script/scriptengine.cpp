@@ -44,3 +44,10 @@ void ScriptEngine::runScript(const QString scriptFilePath) {
 
   engine.evaluate(script);
 }
+
+void ScriptEngine::runCommand(const QString program) {
+  const QJSValue result = engine.evaluate(program);
+  if (result.isError()) {
+    emit log(result.toString(), true);
+  }
+}
@@ -10,10 +10,12 @@
 
 #include "core/simulator.h"
 #include "ui/algorithm.h"
-#include "ui/visitem.h"
 
-// ScriptInterface must be forward declared to avoid a dependency loop.
+// ScriptInterface must be forward declared to avoid a dependency loop. VisItem
+// is only passed through by pointer, so it is forward declared as well; this
+// keeps the script engine free of GUI dependencies in headless builds.
 class ScriptInterface;
+class VisItem;
 
 class ScriptEngine : public QObject {
   Q_OBJECT
@@ -28,6 +30,10 @@ class ScriptEngine : public QObject {
  public slots:
   void runScript(const QString scriptFilePath);
 
+  // Evaluates the given JavaScript program (e.g., a single script command such
+  // as "shapeformation(100, 0.2, 'h')") in this engine.
+  void runCommand(const QString program);
+
  private:
   QJSEngine engine;
   ScriptInterface* scriptInterface;
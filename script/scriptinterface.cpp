@@ -9,14 +9,22 @@
 #include <QTextStream>
 
 #include "alg/shapeformation.h"
+#include "core/amoebotsystem.h"
 #include "core/node.h"
+#include "core/scheduler.h"
+#include "helper/randomnumbergenerator.h"
+#ifndef AMOEBOTSIM_HEADLESS
+#include "ui/visitem.h"
+#endif
 
 ScriptInterface::ScriptInterface(ScriptEngine &engine, Simulator& sim,
                                  VisItem *vis)
   : engine(engine),
     sim(sim),
     vis(vis) {
-  sim.setSystem(std::make_shared<ShapeFormationSystem>(200, 0.2, "h"));
+  auto system = std::make_shared<ShapeFormationSystem>(200, 0.2, "h");
+  system->finishConstruction();
+  sim.setSystem(system);
 }
 
 void ScriptInterface::log(const QString msg, bool error) {
@@ -54,10 +62,26 @@ void ScriptInterface::setStepDuration(const int ms) {
   }
 }
 
+void ScriptInterface::setBatchSize(const int k) {
+  if (k < 0) {
+    log("Batch size must be non-negative", true);
+  } else {
+    sim.setBatchSize(k);
+  }
+}
+
 void ScriptInterface::runUntilTermination() {
   sim.runUntilTermination();
 }
 
+void ScriptInterface::setTerminationCheckInterval(const int k) {
+  if (k < 0) {
+    log("Termination check interval must be non-negative", true);
+  } else {
+    sim.setTerminationCheckInterval(k);
+  }
+}
+
 int ScriptInterface::getNumParticles() {
   return sim.numParticles();
 }
@@ -74,7 +98,17 @@ void ScriptInterface::exportMetrics() {
 QVariant ScriptInterface::getMetric(QString name, bool history) {
   for (const auto& c : sim.getSystem()->getCounts()) {
     if (c->_name == name) {
-      return history ? QVariant::fromValue(c->_history) : c->_value;
+      if (!history) {
+        return c->_value;
+      }
+      // QJSEngine only converts a few sequence types to JS arrays, and vectors
+      // of 64-bit counts are not among them.
+      QVariantList values;
+      values.reserve(static_cast<int>(c->_history.size()));
+      for (const auto value : c->_history) {
+        values.append(static_cast<qreal>(value));
+      }
+      return values;
     }
   }
   for (const auto& m : sim.getSystem()->getMeasures()) {
@@ -86,34 +120,114 @@ QVariant ScriptInterface::getMetric(QString name, bool history) {
   return QVariant();
 }
 
+QString ScriptInterface::getMemoryReport() {
+  return sim.memoryReport();
+}
+
+double ScriptInterface::getLockWaitTime() {
+  return sim.lockWaitTime();
+}
+
+void ScriptInterface::setSeed(const qint64 seed) {
+  if (seed < 0) {
+    log("Seed must be non-negative", true);
+  } else {
+    RandomStream::setNextSeed(static_cast<uint64_t>(seed));
+  }
+}
+
+qint64 ScriptInterface::getSeed() {
+  auto system = std::dynamic_pointer_cast<AmoebotSystem>(sim.getSystem());
+  if (system == nullptr) {
+    log("current system has no random seed", true);
+    return -1;
+  }
+  return static_cast<qint64>(system->getRandomSeed());
+}
+
+void ScriptInterface::setRandomEngine(const QString engine) {
+  if (engine != "mt19937" && engine != "philox") {
+    log("Random engine must be \"mt19937\" or \"philox\"", true);
+  } else {
+    RandomStream::setDefaultEngine(
+        RandomStream::engineFromName(engine.toStdString()));
+  }
+}
+
+void ScriptInterface::setScheduler(const QString scheduler) {
+  if (!Scheduler::isPolicyName(scheduler)) {
+    log("Scheduler must be \"uniform\", \"permutation\", \"sweep\", or "
+        "\"poisson\"", true);
+  } else {
+    Scheduler::setDefaultPolicy(Scheduler::policyFromName(scheduler));
+  }
+}
+
+double ScriptInterface::getSchedulerTime() {
+  auto system = std::dynamic_pointer_cast<AmoebotSystem>(sim.getSystem());
+  if (system == nullptr) {
+    log("current system has no scheduler", true);
+    return 0.0;
+  }
+  return system->schedulerTime();
+}
+
+void ScriptInterface::setQuiescentSkipping(bool skipped) {
+  AmoebotSystem::setQuiescentSkippedByDefault(skipped);
+}
+
 void ScriptInterface::setWindowSize(int width, int height) {
+#ifndef AMOEBOTSIM_HEADLESS
   if(vis != nullptr) {
     vis->setWindowSize(width, height);
   }
+#else
+  Q_UNUSED(width);
+  Q_UNUSED(height);
+#endif
 }
 
 void ScriptInterface::focusOn(int x, int y) {
+#ifndef AMOEBOTSIM_HEADLESS
   if (vis != nullptr) {
     vis->focusOn(Node(x, y));
   }
+#else
+  Q_UNUSED(x);
+  Q_UNUSED(y);
+#endif
 }
 
 void ScriptInterface::setZoom(float zoom) {
+#ifndef AMOEBOTSIM_HEADLESS
   if(vis != nullptr) {
     vis->setZoom(zoom);
   }
+#else
+  Q_UNUSED(zoom);
+#endif
 }
 
 void ScriptInterface::saveScreenshot(QString filePath) {
+#ifdef AMOEBOTSIM_HEADLESS
+  Q_UNUSED(filePath);
+  log("Screenshots are not available in headless mode", true);
+#else
   if(filePath == "") {
     filePath = QString("amoebotsim_") +
                QString::number(QDateTime::currentSecsSinceEpoch()) + ".png";
   }
 
   sim.saveScreenshotSetup(filePath);
+#endif
 }
 
 void ScriptInterface::filmSimulation(QString filePath, const int stepLimit) {
+#ifdef AMOEBOTSIM_HEADLESS
+  Q_UNUSED(filePath);
+  Q_UNUSED(stepLimit);
+  log("Filming is not available in headless mode", true);
+#else
   int fnameLen = 0;
   int temp = stepLimit;
   while (temp >= 10) {
@@ -123,11 +237,12 @@ void ScriptInterface::filmSimulation(QString filePath, const int stepLimit) {
 
   int i = 0;
   while(!sim.getSystem()->hasTerminated() && i < stepLimit) {
-    emit vis->beforeRendering();  // Updates GUI #rounds and #movements labels.
+    emit sim.progressed();  // Updates GUI #rounds and #movements labels.
     saveScreenshot(filePath + pad(i,fnameLen) + QString(".png"));
     step();
     ++i;
   }
+#endif
 }
 
 QString ScriptInterface::pad(const int number, const int length) {
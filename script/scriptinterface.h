@@ -12,7 +12,6 @@
 
 #include "core/simulator.h"
 #include "script/scriptengine.h"
-#include "ui/visitem.h"
 
 class ScriptInterface : public QObject {
   Q_OBJECT
@@ -34,27 +33,64 @@ class ScriptInterface : public QObject {
   // the given value; if this value is negative, an error is logged and the step
   // duration is set to 0. runUntilTermination runs the current algorithm
   // instance until its hasTerminated function returns true.
+  // setTerminationCheckInterval sets how often hasTerminated is evaluated:
+  // after every k-th activation for k >= 1 (1 is the default), or once per
+  // round for k = 0; a negative value is rejected. setBatchSize sets the number
+  // of activations per tick of a running simulation (see
+  // Simulator::setBatchSize); a negative value is rejected.
   void step();
   void setStepDuration(const int ms);
+  void setBatchSize(const int k);
   void runUntilTermination();
+  void setTerminationCheckInterval(const int k);
 
   // Simulator metrics commands. getNumParticles and getNumImmoParticles return the
   // number of particles and objects in the given instance, respectively.
   // exportMetrics writes the metrics to JSON. See simulator.h for further
   // discussion. getMetric returns either the current value (history = false)
   // or the historical data (history = true) of the metric with parameter-
-  // defined name.
+  // defined name. getMemoryReport returns a JSON report of the memory held by
+  // the current instance. getLockWaitTime returns the total time in
+  // milliseconds the simulator waited for the current instance's mutex.
   int getNumParticles();
   int getNumImmoParticles();
   void exportMetrics();
   QVariant getMetric(QString name, bool history = false);
+  QString getMemoryReport();
+  double getLockWaitTime();
+
+  // Random number commands. setSeed sets the seed of the next algorithm
+  // instance (equivalent to passing it as the instance's trailing seed
+  // parameter); a negative seed is rejected. getSeed returns the seed of the
+  // current instance, so that any run can be reproduced later.
+  // setRandomEngine selects the random number engine of subsequently created
+  // instances: "mt19937" (the default) or "philox", a counter-based engine
+  // whose draws depend only on the seed, the particle, and its activation
+  // count. See helper/randomnumbergenerator.h.
+  void setSeed(const qint64 seed);
+  qint64 getSeed();
+  void setRandomEngine(const QString engine);
+
+  // Scheduler commands. setScheduler selects the policy that subsequently
+  // created instances use to choose which particle to activate next:
+  // "uniform" (the default), "permutation", "sweep", or "poisson"; an
+  // instance's trailing scheduler parameter overrides it. getSchedulerTime
+  // returns the continuous time that has passed in the current instance under
+  // the Poisson policy. See core/scheduler.h.
+  void setScheduler(const QString scheduler);
+  double getSchedulerTime();
+
+  // Enables or disables skipping quiescent particles in subsequently created
+  // instances (disabled by default); see AmoebotSystem::setQuiescentSkipped.
+  void setQuiescentSkipping(bool skipped);
 
   // Visualization commands. focusOn centers the window at the given (x,y) node.
   // setZoom sets the zoom level of the window. saveScreenshot saves the current
   // window as a .png in the specified location; if no filepath is provided, a
   // default path is created that ensures no previous screenshots are
   // overwritten. filmSimulation saves a series of screenshots to the specified
-  // location, up to the specified number of steps.
+  // location, up to the specified number of steps. In headless builds there is
+  // no window, so these commands log an error (or do nothing) instead.
   void setWindowSize(int width = 800, int height = 600);
   void focusOn(int x, int y);
   void setZoom(float zoom);
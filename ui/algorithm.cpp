@@ -4,6 +4,11 @@
 
 #include "ui/algorithm.h"
 
+#include <QByteArray>
+#include <QGenericArgument>
+#include <QMetaMethod>
+#include <QVariant>
+
 #include "alg/demo/ballroomdemo.h"
 #include "alg/demo/discodemo.h"
 #include "alg/demo/dynamicdemo.h"
@@ -21,6 +26,9 @@
 #include "alg/leaderelectionbyerosion.h"
 #include "alg/shapeformation.h"
 #include "alg/immobilizedparticles.h"
+#include "core/amoebotsystem.h"
+#include "core/scheduler.h"
+#include "helper/randomnumbergenerator.h"
 
 Algorithm::Algorithm(QString name, QString signature)
     : _name(name),
@@ -64,18 +72,86 @@ void Algorithm::addParameter(QString parameter, QString defaultValue) {
   _parameters.push_back(std::make_pair(parameter, defaultValue));
 }
 
+std::shared_ptr<System> Algorithm::finishSystem(
+    std::shared_ptr<AmoebotSystem> system) {
+  system->finishConstruction();
+  return system;
+}
+
+void Algorithm::prepareNextSystem(const qint64 seed, const QString scheduler) {
+  if (seed >= 0) {
+    RandomStream::setNextSeed(static_cast<uint64_t>(seed));
+  }
+  if (scheduler.isEmpty()) {
+    return;
+  } else if (Scheduler::isPolicyName(scheduler)) {
+    Scheduler::setNextPolicy(Scheduler::policyFromName(scheduler));
+  } else {
+    emit log("unknown scheduler '" + scheduler + "'; using the default", true);
+  }
+}
+
+bool Algorithm::instantiateWith(const QStringList& params) {
+  // QMetaMethod::invoke takes at most ten arguments.
+  const int maxParams = 10;
+  if (params.size() > maxParams) {
+    emit log("too many parameters for " + _signature, true);
+    return false;
+  }
+
+  // moc generates one overload of instantiate() per omittable default
+  // argument, so look for the one whose parameter count matches exactly.
+  const QMetaObject* meta = metaObject();
+  for (int i = meta->methodOffset(); i < meta->methodCount(); ++i) {
+    const QMetaMethod method = meta->method(i);
+    if (method.name() != "instantiate" ||
+        method.parameterCount() != params.size()) {
+      continue;
+    }
+
+    std::vector<QVariant> values;
+    std::vector<QByteArray> typeNames;
+    for (int j = 0; j < params.size(); ++j) {
+      QVariant value(params[j]);
+      if (!value.convert(method.parameterType(j))) {
+        emit log("could not convert parameter '" + params[j] + "' of " +
+                 _signature, true);
+        return false;
+      }
+      values.push_back(value);
+      typeNames.push_back(method.parameterTypeName(j));
+    }
+
+    QGenericArgument args[maxParams];
+    for (int j = 0; j < params.size(); ++j) {
+      args[j] = QGenericArgument(typeNames[j].constData(),
+                                 values[j].constData());
+    }
+    return method.invoke(this, Qt::DirectConnection, args[0], args[1],
+                         args[2], args[3], args[4], args[5], args[6], args[7],
+                         args[8], args[9]);
+  }
+
+  emit log(_signature + " does not take " + QString::number(params.size()) +
+           " parameters", true);
+  return false;
+}
+
 DiscoDemoAlg::DiscoDemoAlg() : Algorithm("Demo: Disco", "discodemo") {
   addParameter("# Particles", "30");
   addParameter("Counter Max", "5");
 };
 
-void DiscoDemoAlg::instantiate(const int numParticles, const int counterMax) {
+void DiscoDemoAlg::instantiate(const int numParticles, const int counterMax,
+                               const qint64 seed, const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (counterMax <= 0) {
     emit log("counterMax must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<DiscoDemoSystem>(numParticles));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<DiscoDemoSystem>(
+        numParticles)));
   }
 }
 
@@ -84,13 +160,16 @@ MetricsDemoAlg::MetricsDemoAlg() : Algorithm("Demo: Metrics", "metricsdemo") {
   addParameter("Counter Max", "5");
 };
 
-void MetricsDemoAlg::instantiate(const int numParticles, const int counterMax) {
+void MetricsDemoAlg::instantiate(const int numParticles, const int counterMax,
+                                 const qint64 seed, const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (counterMax <= 0) {
     emit log("counterMax must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<MetricsDemoSystem>(numParticles));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<MetricsDemoSystem>(
+        numParticles)));
   }
 }
 
@@ -98,8 +177,11 @@ BallroomDemoAlg::BallroomDemoAlg() : Algorithm("Demo: Ballroom", "ballroomdemo")
   addParameter("# Particles", "30");
 }
 
-void BallroomDemoAlg::instantiate(const int numParticles) {
-  emit setSystem(std::make_shared<BallroomDemoSystem>(numParticles));
+void BallroomDemoAlg::instantiate(const int numParticles, const qint64 seed,
+                                  const QString scheduler) {
+  prepareNextSystem(seed, scheduler);
+  emit setSystem(finishSystem(std::make_shared<BallroomDemoSystem>(
+      numParticles)));
 }
 
 TokenDemoAlg::TokenDemoAlg() : Algorithm("Demo: Token Passing", "tokendemo") {
@@ -107,13 +189,16 @@ TokenDemoAlg::TokenDemoAlg() : Algorithm("Demo: Token Passing", "tokendemo") {
   addParameter("Token Lifetime", "100");
 }
 
-void TokenDemoAlg::instantiate(const int numParticles, const int lifetime) {
+void TokenDemoAlg::instantiate(const int numParticles, const int lifetime,
+                               const qint64 seed, const QString scheduler) {
   if (numParticles <= 6) {
     emit log("# particles must be > 6", true);
   } else if (lifetime <= 0) {
     emit log("token lifetime must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<TokenDemoSystem>(numParticles, lifetime));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<TokenDemoSystem>(
+        numParticles, lifetime)));
   }
 }
 
@@ -124,7 +209,8 @@ DynamicDemoAlg::DynamicDemoAlg() : Algorithm("Demo: Dynamic", "dynamicdemo") {
 }
 
 void DynamicDemoAlg::instantiate(const unsigned int numParticles,
-                                 const double growProb, const double dieProb) {
+                                 const double growProb, const double dieProb,
+                                 const qint64 seed, const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (growProb < 0 || growProb > 1) {
@@ -132,8 +218,9 @@ void DynamicDemoAlg::instantiate(const unsigned int numParticles,
   } else if (dieProb < 0 || dieProb > 1) {
     emit log("dieProb in [0,1] required", true);
   } else {
-    emit setSystem(std::make_shared<DynamicDemoSystem>(numParticles, growProb,
-                                                       dieProb));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<DynamicDemoSystem>(
+        numParticles, growProb, dieProb)));
   }
 }
 
@@ -144,7 +231,8 @@ AggregationAlg::AggregationAlg() : Algorithm("Swarm Aggregation", "aggregation")
 }
 
 void AggregationAlg::instantiate(const int numParticles, const QString mode,
-                                 const double noiseVal) {
+                                 const double noiseVal, const qint64 seed,
+                                 const QString scheduler) {
   std::set<QString> set = {"d", "e"};
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
@@ -155,8 +243,9 @@ void AggregationAlg::instantiate(const int numParticles, const QString mode,
   } else if (mode == "e" && (noiseVal < 0 || noiseVal > 1)) {
     emit log("noiseVal must be in [0,1]", true);
   } else {
-    emit setSystem(std::make_shared<AggregateSystem>(numParticles, mode,
-                                                     noiseVal));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<AggregateSystem>(
+        numParticles, mode, noiseVal)));
   }
 }
 
@@ -165,11 +254,14 @@ CompressionAlg::CompressionAlg() : Algorithm("Compression", "compression") {
   addParameter("Lambda", "4.0");
 }
 
-void CompressionAlg::instantiate(const int numParticles, const double lambda) {
+void CompressionAlg::instantiate(const int numParticles, const double lambda,
+                                 const qint64 seed, const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<CompressionSystem>(numParticles, lambda));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<CompressionSystem>(
+        numParticles, lambda)));
   }
 }
 
@@ -188,7 +280,8 @@ void EDFHexagonFormationAlg::instantiate(const int numParticles,
                                          const double holeProb,
                                          const int capacity,
                                          const int transferRate,
-                                         const int demand) {
+                                         const int demand, const qint64 seed,
+                                         const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (numEnergySources <= 0 || numEnergySources > numParticles) {
@@ -202,8 +295,10 @@ void EDFHexagonFormationAlg::instantiate(const int numParticles,
   } else if (demand <= 0 || demand > capacity || demand % transferRate != 0) {
     emit log("demand must be a multiple of transferRate, <= capacity", true);
   } else {
-    emit setSystem(std::make_shared<EDFHexagonFormationSystem>(
-        numParticles, numEnergySources, holeProb, capacity, transferRate, demand));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<EDFHexagonFormationSystem>(
+        numParticles, numEnergySources, holeProb, capacity, transferRate,
+        demand)));
   }
 }
 
@@ -220,7 +315,9 @@ void EDFLeaderElectionByErosionAlg::instantiate(const int numParticles,
                                                 const int numEnergySources,
                                                 const int capacity,
                                                 const int transferRate,
-                                                const int demand) {
+                                                const int demand,
+                                                const qint64 seed,
+                                                const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (numEnergySources <= 0 || numEnergySources > numParticles) {
@@ -232,8 +329,10 @@ void EDFLeaderElectionByErosionAlg::instantiate(const int numParticles,
   } else if (demand <= 0 || demand > capacity || demand % transferRate != 0) {
     emit log("demand must be a multiple of transferRate, <= capacity", true);
   } else {
-    emit setSystem(std::make_shared<EDFLeaderElectionByErosionSystem>(
-        numParticles, numEnergySources, capacity, transferRate, demand));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(
+        std::make_shared<EDFLeaderElectionByErosionSystem>(
+            numParticles, numEnergySources, capacity, transferRate, demand)));
   }
 }
 
@@ -252,7 +351,8 @@ void EnergyShapeAlg::instantiate(const int numParticles,
                                  const double holeProb,
                                  const double capacity,
                                  const double demand,
-                                 const double transferRate) {
+                                 const double transferRate, const qint64 seed,
+                                 const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (numEnergyRoots <= 0 || numEnergyRoots > numParticles) {
@@ -266,9 +366,10 @@ void EnergyShapeAlg::instantiate(const int numParticles,
   } else if (transferRate <= 0) {
     emit log("transferRate must be > 0", true);
   } else {
-    emit setSystem(std:: make_shared<EnergyShapeSystem>(
-                     numParticles, numEnergyRoots, holeProb, capacity, demand,
-                     transferRate));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<EnergyShapeSystem>(
+        numParticles, numEnergyRoots, holeProb, capacity, demand,
+        transferRate)));
   }
 }
 
@@ -287,7 +388,8 @@ void EnergySharingAlg::instantiate(int numParticles,
                                    const int usage,
                                    const double capacity,
                                    const double demand,
-                                   const double transferRate) {
+                                   const double transferRate,
+                                   const qint64 seed, const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (numEnergyRoots <= 0 || numEnergyRoots > numParticles) {
@@ -301,9 +403,9 @@ void EnergySharingAlg::instantiate(int numParticles,
   } else if (transferRate <= 0) {
     emit log("transferRate must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<EnergySharingSystem>(
-                     numParticles, numEnergyRoots, usage, capacity, demand,
-                     transferRate));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<EnergySharingSystem>(
+        numParticles, numEnergyRoots, usage, capacity, demand, transferRate)));
   }
 }
 
@@ -314,14 +416,17 @@ HexagonFormationAlg::HexagonFormationAlg()
 }
 
 void HexagonFormationAlg::instantiate(const int numParticles,
-                                      const double holeProb) {
+                                      const double holeProb,
+                                      const qint64 seed,
+                                      const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (holeProb < 0 || holeProb >= 1) {
     emit log("holeProb in [0,1) required", true);
   } else {
-    emit setSystem(std::make_shared<HexagonFormationSystem>(numParticles,
-                                                            holeProb));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<HexagonFormationSystem>(
+        numParticles, holeProb)));
   }
 }
 
@@ -332,14 +437,16 @@ InfObjCoatingAlg::InfObjCoatingAlg() :
 }
 
 void InfObjCoatingAlg::instantiate(const int numParticles,
-                                   const double holeProb) {
+                                   const double holeProb, const qint64 seed,
+                                   const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (holeProb < 0 || holeProb > 1) {
     emit log("holeProb in [0,1] required", true);
   } else {
-    emit setSystem(std::make_shared<InfObjCoatingSystem>(numParticles,
-                                                         holeProb));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<InfObjCoatingSystem>(
+        numParticles, holeProb)));
   }
 }
 
@@ -350,14 +457,16 @@ LeaderElectionAlg::LeaderElectionAlg() :
 }
 
 void LeaderElectionAlg::instantiate(const int numParticles,
-                                    const double holeProb) {
+                                    const double holeProb, const qint64 seed,
+                                    const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else if (holeProb < 0 || holeProb > 1) {
     emit log("holeProb in [0,1] required", true);
   } else {
-    emit setSystem(std::make_shared<LeaderElectionSystem>(numParticles,
-                                                          holeProb));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<LeaderElectionSystem>(
+        numParticles, holeProb)));
   }
 }
 
@@ -366,11 +475,15 @@ LeaderElectionByErosionAlg::LeaderElectionByErosionAlg() :
   addParameter("# Particles", "91");
 }
 
-void LeaderElectionByErosionAlg::instantiate(const int numParticles) {
+void LeaderElectionByErosionAlg::instantiate(const int numParticles,
+                                             const qint64 seed,
+                                             const QString scheduler) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
   } else {
-    emit setSystem(std::make_shared<LeaderElectionByErosionSystem>(numParticles));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(
+        std::make_shared<LeaderElectionByErosionSystem>(numParticles)));
   }
 }
 
@@ -382,7 +495,9 @@ ShapeFormationAlg::ShapeFormationAlg() :
 }
 
 void ShapeFormationAlg::instantiate(const int numParticles,
-                                    const double holeProb, const QString mode) {
+                                    const double holeProb, const QString mode,
+                                    const qint64 seed,
+                                    const QString scheduler) {
   std::set<QString> set = ShapeFormationSystem::getAcceptedModes();
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
@@ -396,8 +511,9 @@ void ShapeFormationAlg::instantiate(const int numParticles,
     }
     emit log("only accepted modes are: " + accepted, true);
   } else {
-    emit setSystem(std::make_shared<ShapeFormationSystem>(numParticles,
-                                                          holeProb, mode));
+    prepareNextSystem(seed, scheduler);
+    emit setSystem(finishSystem(std::make_shared<ShapeFormationSystem>(
+        numParticles, holeProb, mode)));
   }
 }
 
@@ -409,7 +525,7 @@ ImmobilizedParticlesAlg::ImmobilizedParticlesAlg() :
     addParameter("# Coin Flips", "7");
 }
 
-void ImmobilizedParticlesAlg::instantiate(const int numParticles, const int numImmoParticles, const int genExpExample, const int numCoinFlips) {
+void ImmobilizedParticlesAlg::instantiate(const int numParticles, const int numImmoParticles, const int genExpExample, const int numCoinFlips, const qint64 seed, const QString scheduler) {
     if (numParticles <= 0) {
         emit log("# particles must be > 0", true);
     } else if (numImmoParticles < 0) {
@@ -419,7 +535,9 @@ void ImmobilizedParticlesAlg::instantiate(const int numParticles, const int numI
     } else if (numCoinFlips <= 0) {
         emit log("# coin flips must be > 1", true);
     } else {
-        emit setSystem(std::make_shared<ImmobilizedParticleSystem>(numParticles, numImmoParticles, genExpExample, numCoinFlips));
+        prepareNextSystem(seed, scheduler);
+        emit setSystem(finishSystem(std::make_shared<ImmobilizedParticleSystem>(
+            numParticles, numImmoParticles, genExpExample, numCoinFlips)));
     }
 }
 
@@ -449,10 +567,20 @@ AlgorithmList::AlgorithmList() {
 
   //Thesis
   _algorithms.push_back(new ImmobilizedParticlesAlg());
+
+  // Every instantiate() slot ends with the seed of the new system's random
+  // stream; -1 picks a fresh random seed. The scheduler parameter that follows
+  // it is left to its default here.
+  for (auto alg : _algorithms) {
+    alg->addParameter("Seed", "-1");
+  }
 }
 
 AlgorithmList::~AlgorithmList() {
-  _algorithms.erase(_algorithms.begin(), _algorithms.end());
+  for (auto alg : _algorithms) {
+    delete alg;
+  }
+  _algorithms.clear();
 }
 
 std::vector<Algorithm*> AlgorithmList::getAlgs() {
@@ -15,6 +15,8 @@
 
 #include "core/system.h"
 
+class AmoebotSystem;
+
 class Algorithm : public QObject {
   Q_OBJECT
 
@@ -36,6 +38,28 @@ class Algorithm : public QObject {
   // Adds a parameter to the algorithm of the given name and default value.
   void addParameter(QString parameter, QString defaultValue);
 
+  // Calls this algorithm's instantiate() slot with the given parameters, which
+  // are converted from strings to the slot's parameter types. The overload
+  // taking exactly params.size() arguments is used, so trailing parameters may
+  // be omitted to fall back on their defaults. Returns false (and logs an
+  // error) if there is no such overload or a parameter cannot be converted.
+  bool instantiateWith(const QStringList& params);
+
+ protected:
+  // Prepares the next system created on the calling thread: seeds its random
+  // stream with the given seed, if it is non-negative, and sets its scheduler
+  // policy to the named one (see core/scheduler.h), if the name is not empty.
+  // An unknown scheduler name is logged as an error and the default policy is
+  // used instead. Every instantiate() slot takes trailing seed and scheduler
+  // parameters (default -1 and "", meaning a fresh random seed and the default
+  // policy) and passes them here right before creating its system.
+  void prepareNextSystem(const qint64 seed, const QString scheduler);
+
+  // Ends the construction of the given newly created system (see
+  // AmoebotSystem::finishConstruction) and returns it. Every instantiate() slot
+  // passes its system through here before emitting setSystem.
+  std::shared_ptr<System> finishSystem(std::shared_ptr<AmoebotSystem> system);
+
  signals:
   void log(const QString msg, bool error = false);
   void setSystem(std::shared_ptr<System> system);
@@ -56,7 +80,8 @@ class DiscoDemoAlg : public Algorithm {
   DiscoDemoAlg();
 
  public slots:
-  void instantiate(const int numParticles = 30, const int counterMax = 5);
+  void instantiate(const int numParticles = 30, const int counterMax = 5,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Demo: Metrics.
@@ -67,7 +92,8 @@ class MetricsDemoAlg : public Algorithm {
   MetricsDemoAlg();
 
  public slots:
-  void instantiate(const int numParticles = 30, const int counterMax = 5);
+  void instantiate(const int numParticles = 30, const int counterMax = 5,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Demo: Ballroom, a tutorial in coordination.
@@ -78,7 +104,8 @@ class BallroomDemoAlg : public Algorithm {
   BallroomDemoAlg();
 
  public slots:
-  void instantiate(const int numParticles = 30);
+  void instantiate(const int numParticles = 30, const qint64 seed = -1,
+                   const QString scheduler = "");
 };
 
 // Demo: Token Passing.
@@ -89,7 +116,8 @@ class TokenDemoAlg : public Algorithm {
   TokenDemoAlg();
 
  public slots:
-  void instantiate(const int numParticles = 48, const int lifetime = 100);
+  void instantiate(const int numParticles = 48, const int lifetime = 100,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 class DynamicDemoAlg : public Algorithm {
@@ -100,7 +128,8 @@ class DynamicDemoAlg : public Algorithm {
 
  public slots:
   void instantiate(const unsigned int numParticles = 10,
-                   const double growProb = 0.02, const double dieProb = 0.01);
+                   const double growProb = 0.02, const double dieProb = 0.01,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Aggregation.
@@ -112,7 +141,8 @@ public:
 
 public slots:
   void instantiate(const int numParticles = 2, const QString mode = "d",
-                   const double noiseAmt = 3.0);
+                   const double noiseAmt = 3.0, const qint64 seed = -1,
+                   const QString scheduler = "");
 };
 
 // Compression.
@@ -123,7 +153,8 @@ class CompressionAlg : public Algorithm {
   CompressionAlg();
 
  public slots:
-  void instantiate(const int numParticles = 100, const double lambda = 4.0);
+  void instantiate(const int numParticles = 100, const double lambda = 4.0,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Energy Distribution Framework + Hexagon Formation (canonical).
@@ -136,7 +167,8 @@ class EDFHexagonFormationAlg : public Algorithm {
  public slots:
   void instantiate(const int numParticles = 200, const int numEnergySources = 1,
                    const double holeProb = 0.2, const int capacity = 10,
-                   const int transferRate = 1, const int demand = 5);
+                   const int transferRate = 1, const int demand = 5,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Energy Distribution Framework + Leader Election by Erosion.
@@ -149,7 +181,8 @@ class EDFLeaderElectionByErosionAlg : public Algorithm {
  public slots:
   void instantiate(const int numParticles = 91, const int numEnergySources = 1,
                    const int capacity = 10, const int transferRate = 1,
-                   const int demand = 5);
+                   const int demand = 5, const qint64 seed = -1,
+                   const QString scheduler = "");
 };
 
 // Energy Distribution + Hexagon Formation.
@@ -162,7 +195,8 @@ class EnergyShapeAlg : public Algorithm {
  public slots:
   void instantiate(const int numParticles = 200, const int numEnergyRoots = 1,
                    const double holeProb = 0.2, const double capacity = 10,
-                   const double demand = 5, const double transferRate = 1);
+                   const double demand = 5, const double transferRate = 1,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Energy Distribution/Sharing.
@@ -175,7 +209,8 @@ class EnergySharingAlg : public Algorithm {
  public slots:
   void instantiate(int numParticles = 91, const int numEnergyRoots = 1,
                    const int usage = 0, const double capacity = 10,
-                   const double demand = 5, const double transferRate = 1);
+                   const double demand = 5, const double transferRate = 1,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Hexagon Formation (canonical).
@@ -186,7 +221,8 @@ class HexagonFormationAlg : public Algorithm {
   HexagonFormationAlg();
 
  public slots:
-  void instantiate(const int numParticles = 200, const double holeProb = 0.2);
+  void instantiate(const int numParticles = 200, const double holeProb = 0.2,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Infinite Object Coating.
@@ -197,7 +233,8 @@ class InfObjCoatingAlg : public Algorithm {
   InfObjCoatingAlg();
 
  public slots:
-  void instantiate(const int numParticles = 100, const double holeProb = 0.2);
+  void instantiate(const int numParticles = 100, const double holeProb = 0.2,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 // Leader Election.
@@ -208,7 +245,8 @@ class LeaderElectionAlg : public Algorithm {
   LeaderElectionAlg();
 
  public slots:
-  void instantiate(const int numParticles = 100, const double holeProb = 0.2);
+  void instantiate(const int numParticles = 100, const double holeProb = 0.2,
+                   const qint64 seed = -1, const QString scheduler = "");
 };
 
 
@@ -220,7 +258,8 @@ class LeaderElectionByErosionAlg : public Algorithm {
   LeaderElectionByErosionAlg();
 
  public slots:
-  void instantiate(const int numParticles = 91);
+  void instantiate(const int numParticles = 91, const qint64 seed = -1,
+                   const QString scheduler = "");
 };
 
 // Basic Shape Formation.
@@ -232,7 +271,8 @@ class ShapeFormationAlg : public Algorithm {
 
  public slots:
   void instantiate(const int numParticles = 200, const double holeProb = 0.2,
-                   const QString mode = "h");
+                   const QString mode = "h", const qint64 seed = -1,
+                   const QString scheduler = "");
 };
 
 // immobilizedparticles.
@@ -244,7 +284,8 @@ public:
 
 public slots:
     void instantiate(const int numParticles = 70, const int numImmoParticles = 70,
-                     const int genExpExample = 0, const int numCoinFlips = 7);
+                     const int genExpExample = 0, const int numCoinFlips = 7,
+                     const qint64 seed = -1, const QString scheduler = "");
 };
 
 
@@ -74,64 +74,68 @@ void ParameterListModel::createSystem(QString algName) {
     }
   }
 
+  // The seed is always the last parameter; see AlgorithmList().
+  const qint64 seed = params.back().toLongLong();
+
   if (signature == "discodemo") {
     dynamic_cast<DiscoDemoAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toInt());
+        instantiate(params[0].toInt(), params[1].toInt(), seed);
   } else if (signature == "metricsdemo") {
     dynamic_cast<MetricsDemoAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toInt());
+        instantiate(params[0].toInt(), params[1].toInt(), seed);
   } else if (signature == "ballroomdemo") {
     dynamic_cast<BallroomDemoAlg*>(alg)->
-        instantiate(params[0].toInt());
+        instantiate(params[0].toInt(), seed);
   } else if (signature == "tokendemo") {
     dynamic_cast<TokenDemoAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toInt());
+        instantiate(params[0].toInt(), params[1].toInt(), seed);
   } else if (signature == "dynamicdemo") {
     dynamic_cast<DynamicDemoAlg*>(alg)->
         instantiate(params[0].toInt(), params[1].toDouble(),
-                    params[2].toDouble());
+                    params[2].toDouble(), seed);
   } else if (signature == "aggregation") {
     dynamic_cast<AggregationAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1], params[2].toDouble());
+        instantiate(params[0].toInt(), params[1], params[2].toDouble(), seed);
   } else if (signature == "compression") {
     dynamic_cast<CompressionAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toDouble());
+        instantiate(params[0].toInt(), params[1].toDouble(), seed);
   } else if (signature == "edfhexagonformation") {
     dynamic_cast<EDFHexagonFormationAlg*>(alg)->
         instantiate(params[0].toInt(), params[1].toInt(), params[2].toDouble(),
-                    params[3].toInt(), params[4].toInt(), params[5].toInt());
+                    params[3].toInt(), params[4].toInt(), params[5].toInt(),
+                    seed);
   } else if (signature == "edfleaderelectionbyerosion") {
     dynamic_cast<EDFLeaderElectionByErosionAlg*>(alg)->
         instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(),
-                    params[3].toInt(), params[4].toInt());
+                    params[3].toInt(), params[4].toInt(), seed);
   } else if (signature == "energyshape") {
     dynamic_cast<EnergyShapeAlg*>(alg)->
         instantiate(params[0].toInt(), params[1].toInt(), params[2].toDouble(),
                     params[3].toDouble(), params[4].toDouble(),
-                    params[5].toDouble());
+                    params[5].toDouble(), seed);
   } else if (signature == "energysharing") {
     dynamic_cast<EnergySharingAlg*>(alg)->
         instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(),
                     params[3].toDouble(), params[4].toDouble(),
-                    params[5].toDouble());
+                    params[5].toDouble(), seed);
   } else if (signature == "hexagonformation") {
     dynamic_cast<HexagonFormationAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toDouble());
+        instantiate(params[0].toInt(), params[1].toDouble(), seed);
   } else if (signature == "infobjcoating") {
     dynamic_cast<InfObjCoatingAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toDouble());
+        instantiate(params[0].toInt(), params[1].toDouble(), seed);
   } else if (signature == "leaderelection") {
     dynamic_cast<LeaderElectionAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toDouble());
+        instantiate(params[0].toInt(), params[1].toDouble(), seed);
   } else if (signature == "leaderelectionbyerosion") {
     dynamic_cast<LeaderElectionByErosionAlg*>(alg)->
-        instantiate(params[0].toInt());
+        instantiate(params[0].toInt(), seed);
   } else if (signature == "shapeformation") {
     dynamic_cast<ShapeFormationAlg*>(alg)->
-        instantiate(params[0].toInt(), params[1].toDouble(), params[2]);
+        instantiate(params[0].toInt(), params[1].toDouble(), params[2], seed);
   } else if (signature == "immobilizedparticles") {
       dynamic_cast<ImmobilizedParticlesAlg*>(alg)->
-          instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(), params[3].toInt());
+          instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(), params[3].toInt(), seed);
   }
   else {
     Q_ASSERT(false);  // An unrecognized signature has been entered.
@@ -0,0 +1,103 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "ui/spritebatch.h"
+
+#include <cstdint>
+
+#include <QRgb>
+#include <QtGlobal>
+
+SpriteBatch::SpriteBatch()
+  : glfn(nullptr),
+    vbo(QOpenGLBuffer::VertexBuffer) {}
+
+void SpriteBatch::initialize(QOpenGLFunctions_2_0* glfn) {
+  this->glfn = glfn;
+  vbo.setUsagePattern(QOpenGLBuffer::StreamDraw);
+  vbo.create();
+}
+
+void SpriteBatch::deinitialize() {
+  vbo.destroy();
+  glfn = nullptr;
+}
+
+void SpriteBatch::clear() {
+  vertices.clear();
+}
+
+void SpriteBatch::add(int index, const QPointF& pos, int color, int alpha) {
+  // These values are a consequence of how the particle texture was created. The
+  // expression (90.0f / 96.0f) is done to handle the conversion between 90 dpi
+  // and 96 dpi that Inkscape does when exporting the particle.svg as a .png.
+  static constexpr int texSize = 8;
+  static constexpr float invTexSize = (90.0f / 96.0f) / texSize;
+  static constexpr double halfQuadSideLength = 256.0 / 220.0;
+
+  const float s = invTexSize * (index % texSize);
+  const float t = invTexSize * (index / texSize);
+  const GLfloat left = pos.x() - halfQuadSideLength;
+  const GLfloat right = pos.x() + halfQuadSideLength;
+  const GLfloat bottom = pos.y() - halfQuadSideLength;
+  const GLfloat top = pos.y() + halfQuadSideLength;
+  const GLubyte r = qRed(color), g = qGreen(color), b = qBlue(color);
+  const GLubyte a = alpha;
+
+  vertices.push_back({left, bottom, s, t, r, g, b, a});
+  vertices.push_back({right, bottom, s + invTexSize, t, r, g, b, a});
+  vertices.push_back({right, top, s + invTexSize, t + invTexSize, r, g, b, a});
+  vertices.push_back({left, top, s, t + invTexSize, r, g, b, a});
+}
+
+void SpriteBatch::addQuad(const std::array<QPointF, 4>& corners, int color,
+                          int alpha) {
+  const GLubyte r = qRed(color), g = qGreen(color), b = qBlue(color);
+  const GLubyte a = alpha;
+  for (const QPointF& corner : corners) {
+    const GLfloat x = corner.x(), y = corner.y();
+    vertices.push_back({x, y, 0.0f, 0.0f, r, g, b, a});
+  }
+}
+
+std::size_t SpriteBatch::size() const {
+  return vertices.size() / 4;
+}
+
+void SpriteBatch::draw() {
+  Q_ASSERT(glfn != nullptr);
+
+  if (vertices.empty()) {
+    return;
+  }
+
+  // With a vertex buffer, the array pointers are offsets into the buffer;
+  // without one, they point into the vertices themselves.
+  uintptr_t base = 0;
+  if (vbo.isCreated()) {
+    vbo.bind();
+    vbo.allocate(vertices.data(), vertices.size() * sizeof(Vertex));
+  } else {
+    base = reinterpret_cast<uintptr_t>(vertices.data());
+  }
+
+  glfn->glEnableClientState(GL_VERTEX_ARRAY);
+  glfn->glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glfn->glEnableClientState(GL_COLOR_ARRAY);
+  glfn->glVertexPointer(2, GL_FLOAT, sizeof(Vertex),
+      reinterpret_cast<const GLvoid*>(base + offsetof(Vertex, x)));
+  glfn->glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex),
+      reinterpret_cast<const GLvoid*>(base + offsetof(Vertex, s)));
+  glfn->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex),
+      reinterpret_cast<const GLvoid*>(base + offsetof(Vertex, r)));
+
+  glfn->glDrawArrays(GL_QUADS, 0, vertices.size());
+
+  glfn->glDisableClientState(GL_COLOR_ARRAY);
+  glfn->glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glfn->glDisableClientState(GL_VERTEX_ARRAY);
+  if (vbo.isCreated()) {
+    vbo.release();
+  }
+}
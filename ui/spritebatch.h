@@ -0,0 +1,68 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a sprite batch, which collects the textured quads ("sprites") that
+// the visualization draws from the particle texture and draws all of them with
+// a single call instead of issuing every vertex in immediate mode. The sprites'
+// vertices are packed into a vertex buffer object and drawn in the order they
+// were added, so layers added one after another (e.g., marks, then particles,
+// then borders) overlap as before. Only OpenGL 1.5 features are used: a vertex
+// buffer object with fixed-function vertex, texture coordinate, and color
+// arrays. The batch thus works wherever immediate mode did, including Mesa's
+// software rasterizers, and falls back to drawing from client memory if the
+// vertex buffer cannot be created.
+
+#ifndef AMOEBOTSIM_UI_SPRITEBATCH_H_
+#define AMOEBOTSIM_UI_SPRITEBATCH_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions_2_0>
+#include <QPointF>
+
+class SpriteBatch {
+ public:
+  SpriteBatch();
+
+  // Creates and destroys the vertex buffer. Both must be called with the
+  // OpenGL context current whose functions are given to initialize.
+  void initialize(QOpenGLFunctions_2_0* glfn);
+  void deinitialize();
+
+  // Removes all sprites from the batch, keeping the allocated memory.
+  void clear();
+
+  // Adds a sprite showing the tile at the given index of the particle texture,
+  // centered at the given world position and tinted with the given color in
+  // 0xrrggbb format and alpha value in [0, 255].
+  void add(int index, const QPointF& pos, int color, int alpha);
+
+  // Adds an untextured quad with the given corners in counterclockwise order,
+  // filled with the given color and alpha value. A batch of such quads must be
+  // drawn with texturing disabled.
+  void addQuad(const std::array<QPointF, 4>& corners, int color, int alpha);
+
+  // Returns the number of sprites and quads in the batch.
+  std::size_t size() const;
+
+  // Draws all sprites and quads in the order they were added. The particle
+  // texture must be bound if the batch holds sprites.
+  void draw();
+
+ private:
+  struct Vertex {
+    GLfloat x, y;
+    GLfloat s, t;
+    GLubyte r, g, b, a;
+  };
+
+  QOpenGLFunctions_2_0* glfn;
+  QOpenGLBuffer vbo;
+  std::vector<Vertex> vertices;
+};
+
+#endif  // AMOEBOTSIM_UI_SPRITEBATCH_H_
@@ -10,7 +10,7 @@
 
 // Zoom preferences.
 static constexpr double zoomInit = 16.0;
-static constexpr double zoomMin = 4.0;
+static constexpr double zoomMin = 0.1;
 static constexpr double zoomMax = 128.0;
 static constexpr double zoomAttenuation = 500.0;
 
@@ -44,6 +44,11 @@ double View::top() {
   return _focusPos.y() + halfZoomRec * _viewportHeight;
 }
 
+double View::zoom() {
+  QMutexLocker locker(&mutex);
+  return _zoom;
+}
+
 bool View::includes(const QPointF& headWorldPos) {
   QMutexLocker locker(&mutex);
   static constexpr double slack = 2.0;
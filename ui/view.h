@@ -16,6 +16,7 @@ class View {
   double right();
   double bottom();
   double top();
+  double zoom();
 
   bool includes(const QPointF& headWorldPos);
 
@@ -4,19 +4,25 @@
 
 #include "ui/visitem.h"
 
+#include <algorithm>
 #include <cmath>
 #include <array>
+#include <utility>
+#include <vector>
 #include <QImage>
 #include <QMutexLocker>
 #include <QOpenGLFunctions_2_0>
 #include <QQuickWindow>
-#include <QRgb>
 #include <QtGlobal>
 
 
 // visualisation preferences
 static constexpr float targetFramesPerSecond = 60.0f;
 
+// zoom (pixels per unit of world coordinates) below which particles are too
+// small to make out, so that the densities of the system are drawn instead
+static constexpr double densityZoom = 2.0;
+
 // values derived from the preferences above
 static constexpr float targetFrameDuration = 1000.0f / targetFramesPerSecond;
 
@@ -43,11 +49,12 @@ void VisItem::focusOnCenterOfMass() {
   QPointF sum;
   int numMassPoints = 0;
 
-  for (const Particle& p : *system) {
-    sum = sum + nodeToWorldCoord(p.head);
+  const ParticlePositions& positions = system->positions();
+  for (unsigned int i = 0; i < positions.size(); ++i) {
+    sum = sum + nodeToWorldCoord(positions.headNode(i));
     numMassPoints++;
-    if (p.globalTailDir != -1) {
-      sum = sum + nodeToWorldCoord(p.tail());
+    if (positions.isExpanded(i)) {
+      sum = sum + nodeToWorldCoord(positions.tailNode(i));
       numMassPoints++;
     }
   }
@@ -90,6 +97,9 @@ void VisItem::initialize() {
   particleTex->bind();
   particleTex->generateMipMaps();
 
+  sprites.initialize(glfn);
+  densityCells.initialize(glfn);
+
   Q_ASSERT(window() != nullptr);
   connect(&renderTimer, &QTimer::timeout, window(), &QQuickWindow::update);
 }
@@ -112,17 +122,32 @@ void VisItem::paint() {
   drawGrid();
 
   if (system != nullptr) {
-    QMutexLocker locker(&system->mutex);
+    // Switch to the latest published snapshot, if any, and hand the previous
+    // one back so that the simulator can reuse its storage.
+    std::unique_ptr<RenderSnapshot> latest =
+        system->renderSnapshots.takeLatest();
+    if (latest != nullptr) {
+      system->renderSnapshots.recycle(std::move(snapshot));
+      snapshot = std::move(latest);
+    }
 
-    drawParticles();
+    if (snapshot != nullptr) {
+      if (snapshot->isDensity()) {
+        drawDensities();
+      } else {
+        drawParticles();
+      }
+    }
 
-    drawImmoParticles();
+    emit snapshotRequested(view.zoom() < densityZoom);
   }
 }
 
 void VisItem::deinitialize() {
   renderTimer.disconnect();
 
+  sprites.deinitialize();
+  densityCells.deinitialize();
   particleTex = nullptr;
   gridTex = nullptr;
 }
@@ -166,102 +191,186 @@ void VisItem::drawGrid() {
 }
 
 
-void VisItem::drawParticles() {
-  particleTex->bind();
-  glfn->glBegin(GL_QUADS);
+void VisItem::updateVisibleArea() {
+  // Particles whose head is slightly outside the view may still show parts of
+  // their marks and borders.
+  static constexpr double slack = 2.0;
 
-  // Draw particle marks, then particles, then borders, then border points.
-  for (const Particle& p : *system) {
-    if (view.includes(nodeToWorldCoord(p.head))) {
-      drawMarks(p);
+  visibleArea = QRectF(QPointF(view.left() - slack, view.bottom() - slack),
+                       QPointF(view.right() + slack, view.top() + slack));
+}
+
+void VisItem::findVisibleTiles() {
+  static constexpr int tileShift = RenderSnapshot::tileShift;
+  static constexpr int tileSide = 1 << tileShift;
+
+  updateVisibleArea();
+  visibleTiles.clear();
+
+  // When the view spans more tiles than the snapshot holds, checking each of
+  // the snapshot's tiles is cheaper than looking up each tile in the view.
+  const double numTilesInView =
+      (visibleArea.width() / tileSide + 2) *
+      (visibleArea.height() / (tileSide * triangleHeight) + 2);
+  if (numTilesInView > snapshot->tiles().size()) {
+    for (const RenderSnapshot::Tile& tile : snapshot->tiles()) {
+      if (visibleArea.intersects(tileBounds(tile.origin))) {
+        visibleTiles.push_back(&tile);
+      }
     }
+    return;
   }
-  for (const Particle& p : *system) {
-    if (view.includes(nodeToWorldCoord(p.head))) {
-      drawParticle(p);
+
+  // Node (x, y) lies at world coordinates (x + y / 2, y * triangleHeight), so
+  // the visible nodes of a row of tiles are those whose y lies within the
+  // visible height and whose x lies within the visible width, shifted by half
+  // the row's y values. Note that QRectF's top is the smaller y coordinate,
+  // i.e., the bottom of the view.
+  const int minY = std::floor(visibleArea.top() / triangleHeight);
+  const int maxY = std::ceil(visibleArea.bottom() / triangleHeight);
+  for (int ty = minY >> tileShift; ty <= maxY >> tileShift; ++ty) {
+    const int rowMinY = std::max(minY, ty * tileSide);
+    const int rowMaxY = std::min(maxY, (ty + 1) * tileSide - 1);
+    const int minX = std::floor(visibleArea.left() - 0.5 * rowMaxY);
+    const int maxX = std::ceil(visibleArea.right() - 0.5 * rowMinY);
+    for (int tx = minX >> tileShift; tx <= maxX >> tileShift; ++tx) {
+      const RenderSnapshot::Tile* tile = snapshot->tileAt(Node(tx, ty));
+      if (tile != nullptr) {
+        visibleTiles.push_back(tile);
+      }
     }
   }
-  for (const Particle& p : *system) {
-    if (view.includes(nodeToWorldCoord(p.head))) {
-      drawBorders(p);
+}
+
+QRectF VisItem::tileBounds(const Node& tile) {
+  static constexpr int tileSide = 1 << RenderSnapshot::tileShift;
+
+  // The nodes of a tile form a parallelogram; its corners lie half a node
+  // beyond its outermost nodes.
+  const double minX = tile.x * tileSide - 0.5, maxX = minX + tileSide;
+  const double minY = tile.y * tileSide - 0.5, maxY = minY + tileSide;
+  return QRectF(QPointF(minX + 0.5 * minY, minY * triangleHeight),
+                QPointF(maxX + 0.5 * maxY, maxY * triangleHeight));
+}
+
+void VisItem::drawDensities() {
+  static constexpr int cellsPerTileSide = DensityMap::cellsPerTileSide;
+  static constexpr int cellSide = 1 << DensityMap::cellShift;
+  static constexpr int nodesPerCell = cellSide * cellSide;
+
+  updateVisibleArea();
+  densityCells.clear();
+
+  for (const RenderSnapshot::DensityTile& tile : snapshot->densityTiles()) {
+    if (!visibleArea.intersects(tileBounds(tile.origin))) {
+      continue;
+    }
+    for (int i = 0; i < cellsPerTileSide * cellsPerTileSide; ++i) {
+      const int numOccupied = tile.particles[i] + tile.objects[i];
+      if (numOccupied == 0) {
+        continue;
+      }
+
+      // Shade the cell like the particles or, if it holds any, the objects in
+      // it, more opaque the more of its nodes are occupied.
+      const double minX =
+          (tile.origin.x * cellsPerTileSide + i % cellsPerTileSide) * cellSide
+          - 0.5;
+      const double minY =
+          (tile.origin.y * cellsPerTileSide + i / cellsPerTileSide) * cellSide
+          - 0.5;
+      const double maxX = minX + cellSide, maxY = minY + cellSide;
+      const std::array<QPointF, 4> corners = {{
+        QPointF(minX + 0.5 * minY, minY * triangleHeight),
+        QPointF(maxX + 0.5 * minY, minY * triangleHeight),
+        QPointF(maxX + 0.5 * maxY, maxY * triangleHeight),
+        QPointF(minX + 0.5 * maxY, maxY * triangleHeight)
+      }};
+      const int color = (tile.objects[i] > 0) ? 0xFF0000 : 0x000000;
+      const int alpha =
+          64 + 191 * std::min(numOccupied, nodesPerCell) / nodesPerCell;
+      densityCells.addQuad(corners, color, alpha);
     }
   }
-  for (const Particle& p : *system) {
-    if (view.includes(nodeToWorldCoord(p.head))) {
-      drawBorderPoints(p);
+
+  glfn->glDisable(GL_TEXTURE_2D);
+  densityCells.draw();
+  glfn->glEnable(GL_TEXTURE_2D);
+}
+
+void VisItem::drawParticles() {
+  sprites.clear();
+
+  // Determine the visible particles once from the tiles overlapping the view,
+  // so that the cost of a frame depends on what is on screen rather than on the
+  // size of the system.
+  findVisibleTiles();
+  std::vector<const RenderSnapshot::ParticleState*> visible;
+  for (const RenderSnapshot::Tile* tile : visibleTiles) {
+    for (uint32_t i = 0; i < tile->numParticles; ++i) {
+      const auto& p = snapshot->particles()[tile->firstParticle + i];
+      if (visibleArea.contains(nodeToWorldCoord(p.head))) {
+        visible.push_back(&p);
+      }
     }
   }
 
-  glfn->glEnd();
+  // Draw particle marks, then particles, then borders, then border points.
+  for (const auto* p : visible) {
+    drawMarks(*p);
+  }
+  for (const auto* p : visible) {
+    drawParticle(*p);
+  }
+  for (const auto* p : visible) {
+    drawBorders(*p);
+  }
+  for (const auto* p : visible) {
+    drawBorderPoints(*p);
+  }
+
+  // Draw the objects on top.
+  drawImmoParticles();
+
+  particleTex->bind();
+  sprites.draw();
 }
 
-void VisItem::drawMarks(const Particle& p) {
+void VisItem::drawMarks(const RenderSnapshot::ParticleState& p) {
   // Draw head mark.
-  if (p.headMarkColor() != -1) {
+  if (p.headMarkColor != -1) {
     auto pos = nodeToWorldCoord(p.head);
-    auto color = p.headMarkColor();
-    glfn->glColor4i(qRed(color) << 23, qGreen(color) << 23, qBlue(color) << 23, 180 << 23);
-    drawFromParticleTex(p.headMarkGlobalDir() + 8, pos);
+    sprites.add(p.headMarkDir + 8, pos, p.headMarkColor, 180);
   }
 
   // Draw tail mark.
-  if (p.globalTailDir != -1 && p.tailMarkColor() > -1) {
-    auto pos = nodeToWorldCoord(p.tail());
-    auto color = p.tailMarkColor();
-    glfn->glColor4i(qRed(color) << 23, qGreen(color) << 23, qBlue(color) << 23, 180 << 23);
-    drawFromParticleTex(p.tailMarkGlobalDir() + 8, pos);
+  if (p.tailDir != -1 && p.tailMarkColor > -1) {
+    auto pos = nodeToWorldCoord(p.head.nodeInDir(p.tailDir));
+    sprites.add(p.tailMarkDir + 8, pos, p.tailMarkColor, 180);
   }
 }
 
-void VisItem::drawParticle(const Particle& p) {
+void VisItem::drawParticle(const RenderSnapshot::ParticleState& p) {
   auto pos = nodeToWorldCoord(p.head);
-  glfn->glColor4f(0.0f, 0.0f, 0.0f, 1.0f);
-  drawFromParticleTex(p.globalTailDir + 1, pos);
+  sprites.add(p.tailDir + 1, pos, 0x000000, 255);
 }
 
-void VisItem::drawBorders(const Particle& p) {
+void VisItem::drawBorders(const RenderSnapshot::ParticleState& p) {
   auto pos = nodeToWorldCoord(p.head);
-  for (unsigned int i = 0; i < p.borderColors().size(); ++i) {
-    if (p.borderColors().at(i) != -1) {
-      auto color = p.borderColors().at(i);
-      glfn->glColor4i(qRed(color) << 23, qGreen(color) << 23, qBlue(color) << 23, 180 << 23);
-      drawFromParticleTex(i + 21, pos);
-    }
+  for (unsigned int i = 0; i < p.numBorders; ++i) {
+    const auto& border = snapshot->borders()[p.firstBorder + i];
+    sprites.add(border.index + 21, pos, border.color, 180);
   }
 }
 
-void VisItem::drawBorderPoints(const Particle& p) {
+void VisItem::drawBorderPoints(const RenderSnapshot::ParticleState& p) {
   auto pos = nodeToWorldCoord(p.head);
-  for (unsigned int i = 0; i < p.borderPointColors().size(); ++i) {
-    if (p.borderPointColors().at(i) != -1) {
-      auto color = p.borderPointColors().at(i);
-      glfn->glColor4i(qRed(color) << 23, qGreen(color) << 23, qBlue(color) << 23, 255 << 23);
-      drawFromParticleTex(i + 15, pos);
-    }
+  for (unsigned int i = 0; i < p.numBorderPoints; ++i) {
+    const auto& point = snapshot->borderPoints()[p.firstBorderPoint + i];
+    sprites.add(point.index + 15, pos, point.color, 255);
   }
 }
 
-void VisItem::drawFromParticleTex(int index, const QPointF& pos) {
-  // These values are a consequence of how the particle texture was created. The
-  // expression (90.0f / 96.0f) is done to handle the conversion between 90 dpi
-  // and 96 dpi that Inkscape does when exporting the particle.svg as a .png.
-  static constexpr int texSize = 8;
-  static constexpr double invTexSize = (90.0 / 96.0) / texSize;
-  static constexpr double halfQuadSideLength = 256.0 / 220.0;
-
-  const double column = index % texSize;
-  const double row = index / texSize;
-  const QPointF texOffset(invTexSize * column, invTexSize * row);
-
-  glfn->glTexCoord2d(texOffset.x(), texOffset.y());
-  glfn->glVertex2d(pos.x() - halfQuadSideLength, pos.y() - halfQuadSideLength);
-  glfn->glTexCoord2d(texOffset.x() + invTexSize, texOffset.y());
-  glfn->glVertex2d(pos.x() + halfQuadSideLength, pos.y() - halfQuadSideLength);
-  glfn->glTexCoord2d(texOffset.x() + invTexSize, texOffset.y() + invTexSize);
-  glfn->glVertex2d(pos.x() + halfQuadSideLength, pos.y() + halfQuadSideLength);
-  glfn->glTexCoord2d(texOffset.x(), texOffset.y() + invTexSize);
-  glfn->glVertex2d(pos.x() - halfQuadSideLength, pos.y() + halfQuadSideLength);
-}
 /*
 void VisItem::drawImmoParticles() {
   glfn->glBegin(GL_QUADS);
@@ -275,15 +384,15 @@ void VisItem::drawImmoParticles() {
 }
 */
 void VisItem::drawImmoParticles() {
-    glfn->glBegin(GL_QUADS);
-
-    std::deque<ImmoParticle*> immoparticles = system->getImmoParticles();
-    for (auto t : immoparticles) {
-        drawImmoParticle(*t);
-        drawBordersImmo(*t);
+    for (const RenderSnapshot::Tile* tile : visibleTiles) {
+        for (uint32_t i = 0; i < tile->numObjects; ++i) {
+            const Node& node = snapshot->objects()[tile->firstObject + i];
+            if (visibleArea.contains(nodeToWorldCoord(node))) {
+                drawImmoParticle(node);
+                drawBordersImmo(node);
+            }
+        }
     }
-
-    glfn->glEnd();
 }
 
 std::array<float, 18> createHexagon(float centerX, float centerY, float radius) {
@@ -304,27 +413,22 @@ std::array<float, 18> createHexagon(float centerX, float centerY, float radius)
 
 
 
-void VisItem::drawImmoParticle(const ImmoParticle& t) {
-    auto pos = nodeToWorldCoord(t._node);
+void VisItem::drawImmoParticle(const Node& node) {
+    auto pos = nodeToWorldCoord(node);
 
     // Use default color for immoParticles (e.g., red)
-    glfn->glColor4d(1.0, 0.0, 0.0, 1.0);
+    sprites.add(0, pos, 0xFF0000, 255);
 
-    drawFromParticleTex(0, pos);
-
-    // Draw the border with a different color (e.g., blue with some transparency)
-    glfn->glColor4i(0, 0, 255, 128); // Blue with 50% alpha
-    drawBordersImmo(t);
+    drawBordersImmo(node);
 }
 
-std::array<int, 18> VisItem::drawBordersImmo(const ImmoParticle& t) {
-    auto pos = nodeToWorldCoord(t._node);
+void VisItem::drawBordersImmo(const Node& node) {
+    auto pos = nodeToWorldCoord(node);
 
     // Specify the border color directly
     int borderColor = 0x000000; // Black color
 
-    glfn->glColor4i(qRed(borderColor) << 23, qGreen(borderColor) << 23, qBlue(borderColor) << 23, 180 << 23);
-    drawFromParticleTex(7, pos);
+    sprites.add(7, pos, borderColor, 180);
 
 }
 
@@ -426,10 +530,15 @@ void VisItem::mousePressEvent(QMouseEvent* e) {
       translating = false;
       auto clickedNode = worldCoordToNode(windowCoordToWorldCoord(e->localPos()));
       QString text = "";
-      for (const auto& p : *system) {
-        if (p.head == clickedNode || (p.isExpanded() && p.tail() == clickedNode)) {
-          text = p.inspectionText();
-          break;
+      if (system != nullptr) {
+        // The simulator may be activating particles on its own thread.
+        QMutexLocker locker(&system->mutex);
+        for (const auto& p : *system) {
+          if (p.head == clickedNode ||
+              (p.isExpanded() && p.tail() == clickedNode)) {
+            text = p.inspectionText();
+            break;
+          }
         }
       }
       while (text.endsWith('\n')) {
@@ -6,10 +6,12 @@
 #define AMOEBOTSIM_UI_VISITEM_H_
 
 #include <memory>
+#include <vector>
 
 #include <QMouseEvent>
 #include <QOpenGLTexture>
 #include <QPointF>
+#include <QRectF>
 #include <QString>
 #include <QTimer>
 #include <QWheelEvent>
@@ -17,8 +19,10 @@
 #include "core/node.h"
 #include "core/immoparticle.h"
 #include "core/particle.h"
+#include "core/rendersnapshot.h"
 #include "core/system.h"
 #include "ui/glitem.h"
+#include "ui/spritebatch.h"
 #include "ui/view.h"
 
 class VisItem : public GLItem {
@@ -31,6 +35,12 @@ class VisItem : public GLItem {
   void stepForParticleAt(Node node);
   void inspectParticle(QString text);
 
+  // Emitted after every frame to request a render snapshot of the system's
+  // current state for the next frame, holding the system's densities rather
+  // than its particles if the view is zoomed out far enough; see
+  // Simulator::publishSnapshot.
+  void snapshotRequested(bool density);
+
  public slots:
   void systemChanged(std::shared_ptr<System> _system);
   void focusOnCenterOfMass();
@@ -49,16 +59,29 @@ class VisItem : public GLItem {
   void setupCamera();
 
   void drawGrid();
+  // Functions for drawing the particles and objects of the current render
+  // snapshot, which the renderer reads without locking the system. All but
+  // drawParticles add their sprites to the sprite batch, which drawParticles
+  // then draws with a single call. findVisibleTiles sets visibleArea to the
+  // part of the world shown in the view and collects the snapshot's tiles
+  // that overlap it in visibleTiles; only their particles and objects are
+  // drawn. updateVisibleArea only sets visibleArea, and tileBounds returns the
+  // world coordinates covered by the nodes of the tile with the given
+  // coordinates. drawDensities draws the cells of a density snapshot as
+  // squares shaded by how many of their nodes are occupied, in one call.
+  void updateVisibleArea();
+  void findVisibleTiles();
+  static QRectF tileBounds(const Node& tile);
+  void drawDensities();
   void drawParticles();
-  void drawMarks(const Particle& p);
-  void drawParticle(const Particle& p);
-  void drawBorders(const Particle& p);
-  void drawBorderPoints(const Particle& p);
-  void drawFromParticleTex(int index, const QPointF& pos);
+  void drawMarks(const RenderSnapshot::ParticleState& p);
+  void drawParticle(const RenderSnapshot::ParticleState& p);
+  void drawBorders(const RenderSnapshot::ParticleState& p);
+  void drawBorderPoints(const RenderSnapshot::ParticleState& p);
   void drawImmoParticles();
-  void drawImmoParticle(const ImmoParticle& t);
+  void drawImmoParticle(const Node& node);
   void drawParticleWithBorder(const ImmoParticle& t);
-  std::array<int, 18> drawBordersImmo(const ImmoParticle& t);
+  void drawBordersImmo(const Node& node);
   //void drawHexagon(const QPointF& center, double radius, const QColor& color, bool isBorder);
 
   static QPointF nodeToWorldCoord(const Node& node);
@@ -72,6 +95,8 @@ class VisItem : public GLItem {
  protected:
   std::unique_ptr<QOpenGLTexture> gridTex;
   std::unique_ptr<QOpenGLTexture> particleTex;
+  SpriteBatch sprites;
+  SpriteBatch densityCells;
 
   QTimer renderTimer;
 
@@ -80,6 +105,12 @@ class VisItem : public GLItem {
   bool translating;
 
   std::shared_ptr<System> system;
+
+  // The render snapshot drawn by the render thread, replaced whenever the
+  // simulator has published a newer one.
+  std::unique_ptr<RenderSnapshot> snapshot;
+  QRectF visibleArea;
+  std::vector<const RenderSnapshot::Tile*> visibleTiles;
 };
 
 #endif  // AMOEBOTSIM_UI_VISITEM_H_